@@ -76,19 +76,25 @@ extern "C" {
 #define LILV_URI_OUTPUT_PORT  "http://lv2plug.in/ns/lv2core#OutputPort"
 #define LILV_URI_PORT         "http://lv2plug.in/ns/lv2core#Port"
 
-typedef struct LilvPluginImpl      LilvPlugin;       /**< LV2 Plugin. */
-typedef struct LilvPluginClassImpl LilvPluginClass;  /**< Plugin Class. */
-typedef struct LilvPortImpl        LilvPort;         /**< Port. */
-typedef struct LilvScalePointImpl  LilvScalePoint;   /**< Scale Point. */
-typedef struct LilvUIImpl          LilvUI;           /**< Plugin UI. */
-typedef struct LilvNodeImpl        LilvNode;         /**< Typed Value. */
-typedef struct LilvWorldImpl       LilvWorld;        /**< Lilv World. */
-typedef struct LilvInstanceImpl    LilvInstance;     /**< Plugin instance. */
-typedef struct LilvStateImpl       LilvState;        /**< Plugin state. */
+typedef struct LilvArenaImpl         LilvArena;          /**< Scoped allocator. */
+typedef struct LilvPluginImpl        LilvPlugin;         /**< LV2 Plugin. */
+typedef struct LilvPluginClassImpl   LilvPluginClass;    /**< Plugin Class. */
+typedef struct LilvPluginSummaryImpl LilvPluginSummary;  /**< Plugin summary. */
+typedef struct LilvPortImpl          LilvPort;           /**< Port. */
+typedef struct LilvPortTableImpl     LilvPortTable;      /**< Table of ports. */
+typedef struct LilvPresetImpl        LilvPreset;         /**< Plugin preset. */
+typedef struct LilvQueryImpl         LilvQuery;          /**< Query cursor. */
+typedef struct LilvScalePointImpl    LilvScalePoint;     /**< Scale Point. */
+typedef struct LilvUIImpl            LilvUI;             /**< Plugin UI. */
+typedef struct LilvNodeImpl          LilvNode;           /**< Typed Value. */
+typedef struct LilvWorldImpl         LilvWorld;          /**< Lilv World. */
+typedef struct LilvInstanceImpl      LilvInstance;       /**< Plugin instance. */
+typedef struct LilvStateImpl         LilvState;          /**< Plugin state. */
 
 typedef void LilvIter;           /**< Collection iterator */
 typedef void LilvPluginClasses;  /**< set<PluginClass>. */
 typedef void LilvPlugins;        /**< set<Plugin>. */
+typedef void LilvPresets;        /**< set<Preset>. */
 typedef void LilvScalePoints;    /**< set<ScalePoint>. */
 typedef void LilvUIs;            /**< set<UI>. */
 typedef void LilvNodes;          /**< set<Node>. */
@@ -196,6 +202,10 @@ lilv_node_free(LilvNode* val);
 
 /**
    Duplicate a LilvNode.
+
+   Nodes are immutable and shared within a world, so this only adds a
+   reference and may return `val` itself.  The result must still be freed
+   with lilv_node_free().
 */
 LILV_API LilvNode*
 lilv_node_duplicate(const LilvNode* val);
@@ -467,12 +477,26 @@ lilv_nodes_contains(const LilvNodes* nodes, const LilvNode* value);
 
 /**
    Return a new LilvNodes that contains all nodes from both `a` and `b`.
+
+   If an arena is attached to the world of the nodes, the result is allocated
+   from it like the results of queries.  Otherwise, including if both
+   collections are empty, the result must be freed with lilv_nodes_free().
 */
 LILV_API LilvNodes*
 lilv_nodes_merge(const LilvNodes* a, const LilvNodes* b);
 
 /* Plugins */
 
+/**
+   Free a plugins collection returned by lilv_world_filter_hostable_plugins().
+
+   This does not free the plugins it contains, which are owned by the world.
+   It must not be called on the collection returned by
+   lilv_world_get_all_plugins().
+*/
+LILV_API void
+lilv_plugins_free(LilvPlugins* collection);
+
 LILV_API unsigned
 lilv_plugins_size(const LilvPlugins* collection);
 
@@ -498,6 +522,33 @@ LILV_API const LilvPlugin*
 lilv_plugins_get_by_uri(const LilvPlugins* plugins,
                         const LilvNode*    uri);
 
+/* Presets */
+
+LILV_API unsigned
+lilv_presets_size(const LilvPresets* collection);
+
+LILV_API LilvIter*
+lilv_presets_begin(const LilvPresets* collection);
+
+LILV_API const LilvPreset*
+lilv_presets_get(const LilvPresets* collection, LilvIter* i);
+
+LILV_API LilvIter*
+lilv_presets_next(const LilvPresets* collection, LilvIter* i);
+
+LILV_API bool
+lilv_presets_is_end(const LilvPresets* collection, LilvIter* i);
+
+/**
+   Get a preset from `presets` by URI.
+   Return value is shared (stored in `presets`) and must not be freed or
+   modified by the caller in any way.
+   @return NULL if no preset with `uri` is found in `presets`.
+*/
+LILV_API const LilvPreset*
+lilv_presets_get_by_uri(const LilvPresets* presets,
+                        const LilvNode*    uri);
+
 /**
    @}
    @name World
@@ -537,6 +588,39 @@ lilv_world_new(void);
 */
 #define LILV_OPTION_LV2_PATH "http://drobilla.net/ns/lilv#lv2-path"
 
+/**
+   Set the number of threads used to parse manifests in lilv_world_load_all().
+   If this is greater than 1, bundle manifests are parsed in parallel, then
+   added to the world in the same order as with serial loading, so the
+   resulting world is identical.  The value is an integer, the default is 1.
+*/
+#define LILV_OPTION_DISCOVERY_THREADS "http://drobilla.net/ns/lilv#discovery-threads"
+
+/**
+   Set the discovery index file used by lilv_world_load_all().
+
+   The index caches the manifest data of every discovered bundle, so bundles
+   that have not changed since the last run are discovered without reading
+   any files.  The value is either a file path string, or true to use the
+   default location ($XDG_CACHE_HOME/lilv/discovery-index).  The index is not
+   used by default.
+*/
+#define LILV_OPTION_DISCOVERY_INDEX "http://drobilla.net/ns/lilv#discovery-index"
+
+/**
+   Enable/disable lazy loading of specification data files.
+
+   If this option is true, lilv_world_load_all() does not parse the data files
+   of discovered specifications.  Instead, the data files of a specification
+   are loaded the first time lilv_world_find_nodes(), lilv_world_get(),
+   lilv_world_ask(), or lilv_world_query() is called with a subject (or if
+   there is none, an object) in its namespace, or plugin classes are accessed.
+   Other queries, such as those about plugins, never load specifications.
+   Hosts may load everything explicitly with lilv_world_load_specifications().
+   The default is false.
+*/
+#define LILV_OPTION_LAZY_SPECS "http://drobilla.net/ns/lilv#lazy-specs"
+
 /**
    Set an option option for `world`.
 
@@ -544,12 +628,37 @@ lilv_world_new(void);
    @ref LILV_OPTION_FILTER_LANG
    @ref LILV_OPTION_DYN_MANIFEST
    @ref LILV_OPTION_LV2_PATH
+   @ref LILV_OPTION_DISCOVERY_THREADS
+   @ref LILV_OPTION_DISCOVERY_INDEX
+   @ref LILV_OPTION_LAZY_SPECS
 */
 LILV_API void
 lilv_world_set_option(LilvWorld*      world,
                       const char*     uri,
                       const LilvNode* value);
 
+/**
+   Attach an arena to `world` for allocating query results.
+
+   While an arena is attached, the LilvNodes and LilvScalePoints collections
+   returned by queries (for example lilv_plugin_get_value(),
+   lilv_port_get_value(), lilv_world_find_nodes(), and
+   lilv_port_get_scale_points()) are allocated from the arena, and the arena
+   holds their node references.  These results do not need to be freed
+   individually: freeing them does nothing, and they are all released at once
+   when the arena is reset or freed.  Nodes that must outlive the arena can be
+   kept with lilv_node_duplicate().
+
+   An arena that holds results must be reset or freed before the world is
+   freed, unless it is still attached, in which case freeing the world resets
+   it.
+
+   @param world The world.
+   @param arena The arena to allocate results from, or NULL to detach.
+*/
+LILV_API void
+lilv_world_set_arena(LilvWorld* world, LilvArena* arena);
+
 /**
    Destroy the world, mwahaha.
    It is safe to call this function on NULL.
@@ -613,14 +722,87 @@ lilv_world_load_plugin_classes(LilvWorld* world);
 /**
    Unload a specific bundle.
 
-   This unloads statements loaded by lilv_world_load_bundle().  Note that this
-   is not necessarily all information loaded from the bundle.  If any resources
-   have been separately loaded with lilv_world_load_resource(), they must be
-   separately unloaded with lilv_world_unload_resource().
+   This unloads statements loaded by lilv_world_load_bundle(), and those from
+   data files inside the bundle that were loaded with lilv_world_load_resource()
+   or by loading plugins.  Files outside the bundle that were loaded with
+   lilv_world_load_resource() must be separately unloaded with
+   lilv_world_unload_resource().
 */
 LILV_API int
 lilv_world_unload_bundle(LilvWorld* world, const LilvNode* bundle_uri);
 
+/**
+   Rescan LV2_PATH and update the world to match the installed bundles.
+
+   This compares the bundles currently in LV2_PATH with those found by
+   previous calls to lilv_world_load_all() or lilv_world_rescan().  New
+   bundles are loaded, bundles that no longer exist are unloaded with
+   lilv_world_unload_bundle(), and bundles with any file that has changed
+   since they were loaded are unloaded and loaded again.  Other bundles are
+   not touched.  Finding changes visits every file in every bundle, which is
+   only done here, not when bundles are first loaded.
+
+   As with lilv_world_unload_bundle(), plugins that are removed are not
+   destroyed, so existing pointers to them remain valid, but they are no
+   longer returned by lilv_world_get_all_plugins().
+
+   @param world The world.
+   @param added If non-NULL, set to the URIs of plugins that were added.
+   @param removed If non-NULL, set to the URIs of plugins that were removed.
+   @param changed If non-NULL, set to the URIs of plugins that were reloaded.
+   @return Zero on success, or non-zero if unloading a bundle failed.
+
+   Any returned collections must be freed with lilv_nodes_free().
+*/
+LILV_API int
+lilv_world_rescan(LilvWorld*  world,
+                  LilvNodes** added,
+                  LilvNodes** removed,
+                  LilvNodes** changed);
+
+/**
+   Start watching LV2_PATH for changes in a background thread.
+
+   The watcher monitors every directory in LV2_PATH and every bundle in them,
+   including any subdirectories of bundles.
+   Changes are batched until the file system has been quiet for a short
+   time, then made pending.  The world itself is never modified by the
+   watcher thread, pending changes are only applied when the host calls
+   lilv_world_apply_pending_changes().  The watcher is stopped when the world
+   is freed.
+
+   Directories in LV2_PATH that do not exist when this is called are not
+   watched, use lilv_world_rescan() to pick up bundles in them.
+
+   @return Zero on success, or non-zero if watching is not supported on this
+   system or failed.
+*/
+LILV_API int
+lilv_world_watch(LilvWorld* world);
+
+/**
+   Return true iff the watcher has detected changes that have not been applied.
+
+   This is cheap and may be called regularly, for example from a timer in the
+   host's main loop.
+*/
+LILV_API bool
+lilv_world_has_pending_changes(LilvWorld* world);
+
+/**
+   Apply changes detected by the watcher started with lilv_world_watch().
+
+   Only bundles that the watcher has seen change are touched: they are
+   loaded, unloaded, or reloaded exactly as by lilv_world_rescan(), and the
+   affected plugin URIs are returned the same way.  This must not be called
+   concurrently with any other use of the world.
+*/
+LILV_API int
+lilv_world_apply_pending_changes(LilvWorld*  world,
+                                 LilvNodes** added,
+                                 LilvNodes** removed,
+                                 LilvNodes** changed);
+
 /**
    Load all the data associated with the given `resource`.
    @param world The world.
@@ -673,6 +855,51 @@ lilv_world_get_plugin_classes(const LilvWorld* world);
 LILV_API const LilvPlugins*
 lilv_world_get_all_plugins(const LilvWorld* world);
 
+/**
+   Set the features supported by the host.
+
+   This registers the URIs of `features`, a NULL-terminated array like the one
+   passed to lilv_plugin_instantiate(), for filtering plugins with
+   lilv_world_filter_hostable_plugins().  Any previously set features are
+   replaced.  Only URIs are used, the data of each feature is ignored.
+*/
+LILV_API void
+lilv_world_set_supported_features(LilvWorld*                world,
+                                  const LV2_Feature* const* features);
+
+/**
+   Return all plugins whose required features are supported by the host.
+
+   The features supported by the host are set with
+   lilv_world_set_supported_features().  The required features of each plugin
+   are converted to a bitset the first time it is checked, so later calls are
+   fast enough to use for interactive filtering.
+
+   @return A new collection that must be freed with lilv_plugins_free().  The
+   plugins it contains are owned by `world` and must not be freed.
+*/
+LILV_API LilvPlugins*
+lilv_world_filter_hostable_plugins(LilvWorld* world);
+
+/**
+   Load the data of several plugins in advance.
+
+   Plugin data is normally loaded the first time it is needed, which may stall
+   whatever thread happens to ask first.  This parses the data files of all
+   `plugins` that are not yet loaded, using up to `n_threads` threads, and
+   merges them into the world in the calling thread.  Afterwards, accessing
+   the data of these plugins does not parse any files.
+
+   @param world The world.
+   @param plugins Plugins to load, or NULL for all plugins in the world.
+   @param n_threads Maximum number of parsing threads, including the caller.
+   @return The number of plugins that were loaded.
+*/
+LILV_API unsigned
+lilv_world_preload_plugins(LilvWorld*         world,
+                           const LilvPlugins* plugins,
+                           unsigned           n_threads);
+
 /**
    Find nodes matching a triple pattern.
    Either `subject` or `object` may be NULL (i.e. a wildcard), but not both.
@@ -715,6 +942,32 @@ lilv_world_ask(LilvWorld*      world,
                const LilvNode* predicate,
                const LilvNode* object);
 
+/**
+   Start a streaming query for nodes that match a triple pattern.
+
+   The pattern is interpreted as in lilv_world_find_nodes(), and the same
+   language filtering is applied, but matches are produced one at a time as
+   the query is advanced.  This is useful for taking only the first match, or
+   iterating over matches, without allocating a collection.
+
+   Starting a query allocates the query itself.  Advancing it only allocates
+   for a match that is not already referenced as a node elsewhere, since
+   nodes are shared rather than copied.
+
+   The world must not be modified while the query is in use.  Calls that load
+   data invalidate it, including those that lazily load plugin data, such as
+   the first query about a plugin, and world queries that load specification
+   data if @ref LILV_OPTION_LAZY_SPECS is enabled.
+
+   @return A query positioned at the first match, which must be freed with
+   lilv_query_free(), or NULL if the pattern is invalid.
+*/
+LILV_API LilvQuery*
+lilv_world_query(LilvWorld*      world,
+                 const LilvNode* subject,
+                 const LilvNode* predicate,
+                 const LilvNode* object);
+
 /**
    Get an LV2 symbol for some subject.
 
@@ -725,6 +978,39 @@ lilv_world_ask(LilvWorld*      world,
 LILV_API LilvNode*
 lilv_world_get_symbol(LilvWorld* world, const LilvNode* subject);
 
+/**
+   @}
+   @name Arena
+   @{
+*/
+
+/**
+   Create a new arena for scoped allocation of query results.
+
+   @param block_size Size of each block of memory in bytes, or zero to use a
+   default size.
+   @return A new arena which must be freed with lilv_arena_free(), or NULL.
+*/
+LILV_API LilvArena*
+lilv_arena_new(size_t block_size);
+
+/**
+   Release everything that was allocated from `arena`.
+
+   Memory is kept and reused for later allocations, so this only takes time
+   proportional to the number of nodes held by results.  Any results allocated
+   from `arena` must no longer be used.
+*/
+LILV_API void
+lilv_arena_reset(LilvArena* arena);
+
+/**
+   Free `arena` and everything allocated from it.
+   The arena must not be attached to a world.
+*/
+LILV_API void
+lilv_arena_free(LilvArena* arena);
+
 /**
    @}
    @name Plugin
@@ -806,6 +1092,24 @@ lilv_plugin_get_library_uri(const LilvPlugin* plugin);
 LILV_API LilvNode*
 lilv_plugin_get_name(const LilvPlugin* plugin);
 
+/**
+   Get a summary of the basic information about `plugin`.
+
+   Unlike the individual accessors like lilv_plugin_get_name(), this does not
+   load the plugin data files if the name, class, and binary can be found in
+   the manifest or other data that is already loaded.  This makes it suitable
+   for listing many plugins quickly.  The project is taken from the same data,
+   so it may be missing if it is only given in a plugin data file that has
+   not been loaded yet.
+
+   The summary is built on the first call and owned by `plugin`.  Once the
+   plugin data files have been loaded, the next call fills in anything that
+   was missing.  The summary remains valid until the plugin is reloaded or
+   destroyed.
+*/
+LILV_API const LilvPluginSummary*
+lilv_plugin_get_summary(const LilvPlugin* plugin);
+
 /**
    Get the class this plugin belongs to (e.g. Filters).
 */
@@ -828,6 +1132,16 @@ LILV_API LilvNodes*
 lilv_plugin_get_value(const LilvPlugin* plugin,
                       const LilvNode*   predicate);
 
+/**
+   Start a streaming query for values associated with the plugin.
+
+   This is a streaming analog of lilv_plugin_get_value() which does not
+   allocate a collection, see lilv_world_query() for details.
+*/
+LILV_API LilvQuery*
+lilv_plugin_query_value(const LilvPlugin* plugin,
+                        const LilvNode*   predicate);
+
 /**
    Return whether a feature is supported by a plugin.
    This will return true if the feature is an optional or required feature
@@ -987,6 +1301,16 @@ lilv_plugin_get_port_by_designation(const LilvPlugin* plugin,
                                     const LilvNode*   port_class,
                                     const LilvNode*   designation);
 
+/**
+   Get a compiled table of the commonly used properties of all ports.
+
+   The table is built when the ports of `plugin` are loaded, like the ports
+   themselves, and is immutable afterwards.  It is owned by `plugin` and
+   remains valid until the plugin is reloaded or destroyed.
+*/
+LILV_API const LilvPortTable*
+lilv_plugin_get_port_table(const LilvPlugin* plugin);
+
 /**
    Get the project the plugin is a part of.
 
@@ -1029,6 +1353,16 @@ lilv_plugin_get_author_homepage(const LilvPlugin* plugin);
 LILV_API bool
 lilv_plugin_is_replaced(const LilvPlugin* plugin);
 
+/**
+   Get the URI of a known plugin that replaces `plugin`.
+
+   This returns NULL if `plugin` is not replaced, or is only replaced by
+   plugins that are not installed.  Hosts can use this to migrate sessions
+   from deprecated plugins.  Returned value is shared and must not be freed.
+*/
+LILV_API const LilvNode*
+lilv_plugin_get_replaced_by(const LilvPlugin* plugin);
+
 /**
    Write the Turtle description of `plugin` to `plugin_file`.
 
@@ -1070,6 +1404,27 @@ lilv_plugin_write_manifest_entry(LilvWorld*        world,
 LILV_API LilvNodes*
 lilv_plugin_get_related(const LilvPlugin* plugin, const LilvNode* type);
 
+/**
+   Get the presets for `plugin` without allocating a new collection.
+
+   This returns every pset:Preset that applies to `plugin`, sorted by URI,
+   with its label and bank if they are known.  Presets are indexed the first
+   time they are requested, so subsequent calls only cost time proportional to
+   the number of presets.  Labels and banks that are described in preset
+   files are only available after the preset has been loaded with
+   lilv_world_load_resource().
+
+   The returned collection is shared and must not be freed.  When more data is
+   loaded, it is updated in place on the next call, so it is safe to load each
+   preset while iterating over them.  A preset remains valid until its data is
+   removed from the world or the plugin is reloaded, but its label and bank
+   may be replaced when it is updated.  Presets that are blank nodes are not
+   included, use lilv_plugin_get_related() to find them.  Returns NULL if the
+   plugin has no presets.
+*/
+LILV_API const LilvPresets*
+lilv_plugin_get_presets(const LilvPlugin* plugin);
+
 /**
    @}
    @name Port
@@ -1211,6 +1566,145 @@ LILV_API LilvScalePoints*
 lilv_port_get_scale_points(const LilvPlugin* plugin,
                            const LilvPort*   port);
 
+/**
+   @}
+   @name Plugin Summary
+   A plugin summary holds the basic information about a plugin which is needed
+   to list it.  It is returned by lilv_plugin_get_summary().
+   @{
+*/
+
+/**
+   Return the name (doap:name) of a plugin, or NULL if it has none.
+*/
+LILV_API const LilvNode*
+lilv_plugin_summary_get_name(const LilvPluginSummary* summary);
+
+/**
+   Return the most specific known class of a plugin.
+*/
+LILV_API const LilvPluginClass*
+lilv_plugin_summary_get_class(const LilvPluginSummary* summary);
+
+/**
+   Return the URI of the shared library (lv2:binary) of a plugin, or NULL.
+*/
+LILV_API const LilvNode*
+lilv_plugin_summary_get_library_uri(const LilvPluginSummary* summary);
+
+/**
+   Return the project (lv2:project) of a plugin, or NULL.
+*/
+LILV_API const LilvNode*
+lilv_plugin_summary_get_project(const LilvPluginSummary* summary);
+
+/**
+   Return the minor version (lv2:minorVersion) of a plugin, or 0.
+*/
+LILV_API int
+lilv_plugin_summary_get_minor_version(const LilvPluginSummary* summary);
+
+/**
+   Return the micro version (lv2:microVersion) of a plugin, or 0.
+*/
+LILV_API int
+lilv_plugin_summary_get_micro_version(const LilvPluginSummary* summary);
+
+/**
+   @}
+   @name Port Table
+   A port table holds the commonly used properties of all ports of a plugin
+   in contiguous arrays, where the element at index i describes the port with
+   index i.  It is returned by lilv_plugin_get_port_table().
+   @{
+*/
+
+/**
+   Direction and type of a port in a port table.
+*/
+typedef enum {
+	LILV_PORT_INPUT   = 1u << 0,  /**< lv2:InputPort */
+	LILV_PORT_OUTPUT  = 1u << 1,  /**< lv2:OutputPort */
+	LILV_PORT_AUDIO   = 1u << 2,  /**< lv2:AudioPort */
+	LILV_PORT_CONTROL = 1u << 3,  /**< lv2:ControlPort */
+	LILV_PORT_CV      = 1u << 4,  /**< lv2:CVPort */
+	LILV_PORT_ATOM    = 1u << 5,  /**< atom:AtomPort */
+	LILV_PORT_EVENT   = 1u << 6   /**< ev:EventPort */
+} LilvPortFlags;
+
+/**
+   Well-known properties (lv2:portProperty) of a port in a port table.
+*/
+typedef enum {
+	LILV_PORT_CONNECTION_OPTIONAL = 1u << 0,  /**< lv2:connectionOptional */
+	LILV_PORT_ENUMERATION         = 1u << 1,  /**< lv2:enumeration */
+	LILV_PORT_INTEGER             = 1u << 2,  /**< lv2:integer */
+	LILV_PORT_IS_SIDE_CHAIN       = 1u << 3,  /**< lv2:isSideChain */
+	LILV_PORT_REPORTS_LATENCY     = 1u << 4,  /**< lv2:reportsLatency */
+	LILV_PORT_SAMPLE_RATE         = 1u << 5,  /**< lv2:sampleRate */
+	LILV_PORT_TOGGLED             = 1u << 6,  /**< lv2:toggled */
+	LILV_PORT_CAUSES_ARTIFACTS    = 1u << 7,  /**< pprops:causesArtifacts */
+	LILV_PORT_EXPENSIVE           = 1u << 8,  /**< pprops:expensive */
+	LILV_PORT_LOGARITHMIC         = 1u << 9,  /**< pprops:logarithmic */
+	LILV_PORT_NOT_ON_GUI          = 1u << 10, /**< pprops:notOnGUI */
+	LILV_PORT_TRIGGER             = 1u << 11  /**< pprops:trigger */
+} LilvPortPropertyFlags;
+
+/**
+   Get the number of ports in a port table.
+*/
+LILV_API uint32_t
+lilv_port_table_get_num_ports(const LilvPortTable* table);
+
+/**
+   Get the symbols of all ports.
+   Returned array is owned by `table` and must not be freed by caller.
+*/
+LILV_API const LilvNode* const*
+lilv_port_table_get_symbols(const LilvPortTable* table);
+
+/**
+   Get the direction and type of all ports, as LilvPortFlags.
+   Returned array is owned by `table` and must not be freed by caller.
+*/
+LILV_API const uint32_t*
+lilv_port_table_get_flags(const LilvPortTable* table);
+
+/**
+   Get the well-known properties of all ports, as LilvPortPropertyFlags.
+   Returned array is owned by `table` and must not be freed by caller.
+*/
+LILV_API const uint32_t*
+lilv_port_table_get_properties(const LilvPortTable* table);
+
+/**
+   Get the minimum values of all ports, or NAN where there is none.
+   Returned array is owned by `table` and must not be freed by caller.
+*/
+LILV_API const float*
+lilv_port_table_get_minimums(const LilvPortTable* table);
+
+/**
+   Get the maximum values of all ports, or NAN where there is none.
+   Returned array is owned by `table` and must not be freed by caller.
+*/
+LILV_API const float*
+lilv_port_table_get_maximums(const LilvPortTable* table);
+
+/**
+   Get the default values of all ports, or NAN where there is none.
+   Returned array is owned by `table` and must not be freed by caller.
+*/
+LILV_API const float*
+lilv_port_table_get_defaults(const LilvPortTable* table);
+
+/**
+   Get the designations of all ports, or NULL where there is none.
+   Returned array is owned by `table` and must not be freed by caller.
+*/
+LILV_API const LilvNode* const*
+lilv_port_table_get_designations(const LilvPortTable* table);
+
 /**
    @}
    @name Plugin State
@@ -1568,6 +2062,68 @@ lilv_scale_point_get_label(const LilvScalePoint* point);
 LILV_API const LilvNode*
 lilv_scale_point_get_value(const LilvScalePoint* point);
 
+/**
+   @}
+   @name Preset
+   @{
+*/
+
+/**
+   Get the URI of `preset`.
+   Returned value is owned by `preset` and must not be freed.
+*/
+LILV_API const LilvNode*
+lilv_preset_get_uri(const LilvPreset* preset);
+
+/**
+   Get the rdfs:label of `preset`, or NULL if it has none.
+   Returned value is owned by `preset` and must not be freed.
+*/
+LILV_API const LilvNode*
+lilv_preset_get_label(const LilvPreset* preset);
+
+/**
+   Get the pset:bank of `preset`, or NULL if it has none.
+   Returned value is owned by `preset` and must not be freed.
+*/
+LILV_API const LilvNode*
+lilv_preset_get_bank(const LilvPreset* preset);
+
+/**
+   @}
+   @name Query
+   @{
+*/
+
+/**
+   Return true iff `query` has no more matches.
+*/
+LILV_API bool
+lilv_query_is_end(const LilvQuery* query);
+
+/**
+   Get the current match of `query`, or NULL if it is at the end.
+
+   Returned value is owned by `query` and must not be freed.  It remains valid
+   until `query` is advanced or freed, and may be kept for longer with
+   lilv_node_duplicate().
+*/
+LILV_API const LilvNode*
+lilv_query_get(const LilvQuery* query);
+
+/**
+   Advance `query` to the next match.
+   @return True iff `query` has reached the end.
+*/
+LILV_API bool
+lilv_query_next(LilvQuery* query);
+
+/**
+   Free `query`.
+*/
+LILV_API void
+lilv_query_free(LilvQuery* query);
+
 /**
    @}
    @name Plugin Class
@@ -1603,6 +2159,44 @@ lilv_plugin_class_get_label(const LilvPluginClass* plugin_class);
 LILV_API LilvPluginClasses*
 lilv_plugin_class_get_children(const LilvPluginClass* plugin_class);
 
+/**
+   Get the superclass of this plugin class.
+   Returns NULL if the class is a root, or its superclass is not known.
+*/
+LILV_API const LilvPluginClass*
+lilv_plugin_class_get_parent(const LilvPluginClass* plugin_class);
+
+/**
+   Get the depth of this plugin class in the class hierarchy.
+   This is the number of known ancestors, so roots have depth 0.
+*/
+LILV_API unsigned
+lilv_plugin_class_get_depth(const LilvPluginClass* plugin_class);
+
+/**
+   Get the number of direct subclasses of this plugin class.
+*/
+LILV_API unsigned
+lilv_plugin_class_get_num_children(const LilvPluginClass* plugin_class);
+
+/**
+   Get the direct subclass of this plugin class at `index`.
+
+   Subclasses are ordered by URI.  Unlike lilv_plugin_class_get_children(),
+   this does not allocate.  Returns NULL if `index` is out of range.
+*/
+LILV_API const LilvPluginClass*
+lilv_plugin_class_get_child(const LilvPluginClass* plugin_class,
+                            unsigned               index);
+
+/**
+   Return true iff `plugin_class` is a (possibly indirect) subclass of
+   `ancestor`.  This takes constant time.
+*/
+LILV_API bool
+lilv_plugin_class_is_descendant_of(const LilvPluginClass* plugin_class,
+                                   const LilvPluginClass* ancestor);
+
 /**
    @}
    @name Plugin Instance
@@ -1774,6 +2368,16 @@ lilv_instance_get_handle(const LilvInstance* instance)
 LILV_API LilvUIs*
 lilv_plugin_get_uis(const LilvPlugin* plugin);
 
+/**
+   Get all UIs for `plugin` without allocating a new collection.
+
+   The returned collection is shared and must not be freed.  It remains valid
+   until data is loaded into or removed from the world, or the plugin is
+   reloaded.  Returns NULL if the plugin has no UIs.
+*/
+LILV_API const LilvUIs*
+lilv_plugin_get_all_uis(const LilvPlugin* plugin);
+
 /**
    Get the URI of a Plugin UI.
    @param ui The Plugin UI
@@ -0,0 +1,178 @@
+/*
+  Copyright 2007-2019 David Robillard <http://drobilla.net>
+
+  Permission to use, copy, modify, and/or distribute this software for any
+  purpose with or without fee is hereby granted, provided that the above
+  copyright notice and this permission notice appear in all copies.
+
+  THIS SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+  WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+  MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+  ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+  WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+  ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+  OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+
+#include "lilv_internal.h"
+
+#include "lilv/lilv.h"
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+#define LILV_ARENA_ALIGN      16U
+#define LILV_ARENA_BLOCK_SIZE 4096U
+
+typedef struct LilvArenaBlockImpl LilvArenaBlock;
+
+struct LilvArenaBlockImpl {
+	LilvArenaBlock* next;  ///< Next block, kept for reuse after a reset
+	size_t          size;  ///< Size of data in bytes
+	size_t          used;  ///< Number of used data bytes
+};
+
+typedef struct LilvArenaRefImpl LilvArenaRef;
+
+struct LilvArenaRefImpl {
+	LilvArenaRef* next;  ///< Next held node
+	LilvNode*     node;  ///< Node referenced by a result in the arena
+};
+
+struct LilvArenaImpl {
+	size_t          block_size;  ///< Default size of block data
+	LilvArenaBlock* head;        ///< First block
+	LilvArenaBlock* current;     ///< Block currently being allocated from
+	LilvArenaRef*   refs;        ///< Node references to release on reset
+};
+
+static inline size_t
+lilv_arena_align(size_t size)
+{
+	return (size + LILV_ARENA_ALIGN - 1U) & ~(size_t)(LILV_ARENA_ALIGN - 1U);
+}
+
+static inline uint8_t*
+lilv_arena_block_data(LilvArenaBlock* block)
+{
+	return (uint8_t*)block + lilv_arena_align(sizeof(LilvArenaBlock));
+}
+
+static LilvArenaBlock*
+lilv_arena_block_new(size_t size, LilvArenaBlock* next)
+{
+	LilvArenaBlock* block = (LilvArenaBlock*)malloc(
+		lilv_arena_align(sizeof(LilvArenaBlock)) + size);
+	if (block) {
+		block->next = next;
+		block->size = size;
+		block->used = 0;
+	}
+	return block;
+}
+
+LILV_API LilvArena*
+lilv_arena_new(size_t block_size)
+{
+	LilvArena* arena = (LilvArena*)malloc(sizeof(LilvArena));
+	if (!arena) {
+		return NULL;
+	}
+
+	arena->block_size = lilv_arena_align(
+		block_size ? block_size : LILV_ARENA_BLOCK_SIZE);
+	arena->head    = lilv_arena_block_new(arena->block_size, NULL);
+	arena->current = arena->head;
+	arena->refs    = NULL;
+	if (!arena->head) {
+		free(arena);
+		return NULL;
+	}
+	return arena;
+}
+
+/** Release the node references held by results allocated from `arena`. */
+static void
+lilv_arena_release_nodes(LilvArena* arena)
+{
+	for (LilvArenaRef* r = arena->refs; r; r = r->next) {
+		lilv_node_free(r->node);
+	}
+	arena->refs = NULL;
+}
+
+LILV_API void
+lilv_arena_reset(LilvArena* arena)
+{
+	lilv_arena_release_nodes(arena);
+
+	// Blocks are kept and reused in order, so only the first must be reset
+	arena->current       = arena->head;
+	arena->current->used = 0;
+}
+
+LILV_API void
+lilv_arena_free(LilvArena* arena)
+{
+	if (arena) {
+		lilv_arena_release_nodes(arena);
+		for (LilvArenaBlock* b = arena->head; b;) {
+			LilvArenaBlock* const next = b->next;
+			free(b);
+			b = next;
+		}
+		free(arena);
+	}
+}
+
+void*
+lilv_arena_alloc(LilvArena* arena, size_t size)
+{
+	size = lilv_arena_align(size);
+
+	LilvArenaBlock* block = arena->current;
+	if (block->size - block->used < size) {
+		if (block->next && block->next->size >= size) {
+			// Reuse the next block left over from before a reset
+			block       = block->next;
+			block->used = 0;
+		} else {
+			// Insert a new block large enough for this allocation
+			const size_t block_size = (size > arena->block_size
+			                           ? size
+			                           : arena->block_size);
+			block = lilv_arena_block_new(block_size, block->next);
+			if (!block) {
+				return NULL;
+			}
+			arena->current->next = block;
+		}
+		arena->current = block;
+	}
+
+	uint8_t* const ptr = lilv_arena_block_data(block) + block->used;
+	block->used += size;
+	return ptr;
+}
+
+/**
+   Transfer a reference to `node` to `arena`, to be released on reset.
+
+   @return `node`, or NULL (after releasing it) if allocation failed.
+*/
+LilvNode*
+lilv_arena_hold(LilvArena* arena, LilvNode* node)
+{
+	LilvArenaRef* const ref = (LilvArenaRef*)lilv_arena_alloc(
+		arena, sizeof(LilvArenaRef));
+	if (!ref) {
+		lilv_node_free(node);
+		return NULL;
+	}
+
+	ref->next   = arena->refs;
+	ref->node   = node;
+	arena->refs = ref;
+	return node;
+}
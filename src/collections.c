@@ -24,11 +24,13 @@
 #include <stdbool.h>
 #include <stddef.h>
 #include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
 
 int
 lilv_ptr_cmp(const void* a, const void* b, void* user_data)
 {
-	return (intptr_t)a - (intptr_t)b;
+	return ((uintptr_t)a < (uintptr_t)b) ? -1 : ((uintptr_t)a > (uintptr_t)b);
 }
 
 int
@@ -74,27 +76,309 @@ lilv_collection_get(const LilvCollection* collection,
 	return zix_tree_get((const ZixTreeIter*)i);
 }
 
+/* Sorted arrays */
+
+static LilvArray*
+lilv_array_new(LilvArena*     arena,
+               ZixComparator  cmp,
+               ZixDestroyFunc destroy,
+               bool           unique)
+{
+	LilvArray* array = (LilvArray*)(arena
+	                                ? lilv_arena_alloc(arena, sizeof(LilvArray))
+	                                : malloc(sizeof(LilvArray)));
+	if (array) {
+		array->elems    = NULL;
+		array->n_elems  = 0;
+		array->capacity = 0;
+		array->cmp      = cmp;
+		array->destroy  = destroy;
+		array->unique   = unique;
+		array->sorted   = true;
+		array->arena    = arena;
+	}
+	return array;
+}
+
+static void
+lilv_array_free(LilvArray* array)
+{
+	// Arrays in an arena are released along with everything else in it
+	if (array && !array->arena) {
+		if (array->destroy) {
+			for (unsigned i = 0; i < array->n_elems; ++i) {
+				array->destroy(array->elems[i]);
+			}
+		}
+		free(array->elems);
+		free(array);
+	}
+}
+
+/** Grow the elements of `array` to at least `capacity`. */
+static ZixStatus
+lilv_array_reserve(LilvArray* array, unsigned capacity)
+{
+	void** elems = NULL;
+	if (array->arena) {
+		elems = (void**)lilv_arena_alloc(array->arena, capacity * sizeof(void*));
+		if (elems && array->n_elems) {
+			memcpy(elems, array->elems, array->n_elems * sizeof(void*));
+		}
+	} else {
+		elems = (void**)realloc(array->elems, capacity * sizeof(void*));
+	}
+
+	if (!elems) {
+		return ZIX_STATUS_NO_MEM;
+	}
+
+	array->elems    = elems;
+	array->capacity = capacity;
+	return ZIX_STATUS_SUCCESS;
+}
+
+/** Merge the sorted runs src[lo..mid) and src[mid..hi) into dst[lo..hi). */
+static void
+lilv_array_merge(ZixComparator cmp,
+                 void**        dst,
+                 void* const*  src,
+                 unsigned      lo,
+                 unsigned      mid,
+                 unsigned      hi)
+{
+	unsigned i = lo;
+	unsigned j = mid;
+	for (unsigned k = lo; k < hi; ++k) {
+		// Take from the left run on ties to keep equal elements in order
+		if (i < mid && (j == hi || cmp(src[i], src[j], NULL) <= 0)) {
+			dst[k] = src[i++];
+		} else {
+			dst[k] = src[j++];
+		}
+	}
+}
+
+/** Sort the elements of `array` in place, without allocating. */
+static void
+lilv_array_insertion_sort(LilvArray* array)
+{
+	for (unsigned i = 1; i < array->n_elems; ++i) {
+		void* const elem = array->elems[i];
+		unsigned    j    = i;
+		for (; j > 0 && array->cmp(array->elems[j - 1], elem, NULL) > 0; --j) {
+			array->elems[j] = array->elems[j - 1];
+		}
+		array->elems[j] = elem;
+	}
+}
+
+/**
+   Sort the elements of `array` if they were not appended in order.
+
+   The sort is stable, so if the array is unique, the first of several equal
+   elements is kept, and the others are destroyed.
+*/
+static void
+lilv_array_sort(LilvArray* array)
+{
+	const unsigned n   = array->n_elems;
+	void**         buf = (void**)malloc(n * sizeof(void*));
+	if (buf) {
+		// Bottom-up merge sort, alternating between elems and buf
+		void** src = array->elems;
+		void** dst = buf;
+		for (unsigned width = 1; width < n; width *= 2) {
+			for (unsigned lo = 0; lo < n; lo += 2 * width) {
+				const unsigned mid = (n - lo > width) ? lo + width : n;
+				const unsigned hi  = (n - mid > width) ? mid + width : n;
+				lilv_array_merge(array->cmp, dst, src, lo, mid, hi);
+			}
+			void** const tmp = src;
+			src              = dst;
+			dst              = tmp;
+		}
+
+		if (src != array->elems) {
+			memcpy(array->elems, src, n * sizeof(void*));
+		}
+		free(buf);
+	} else {
+		lilv_array_insertion_sort(array);
+	}
+
+	if (array->unique) {
+		unsigned n_unique = 0;
+		for (unsigned i = 0; i < n; ++i) {
+			void* const elem = array->elems[i];
+			if (n_unique > 0 &&
+			    !array->cmp(array->elems[n_unique - 1], elem, NULL)) {
+				if (array->destroy) {
+					array->destroy(elem);
+				}
+			} else {
+				array->elems[n_unique++] = elem;
+			}
+		}
+		array->n_elems = n_unique;
+	}
+
+	array->sorted = true;
+}
+
+/** Return `array`, after sorting it if elements were appended out of order. */
+static const LilvArray*
+lilv_array_sorted(const LilvArray* array)
+{
+	if (array && !array->sorted) {
+		lilv_array_sort((LilvArray*)array);
+	}
+	return array;
+}
+
+/**
+   Append `elem` to `array`.
+
+   Collections are usually built in order, in which case the array stays
+   sorted.  Otherwise, it is sorted once before it is next read.  Like
+   zix_tree_insert(), this returns ZIX_STATUS_EXISTS if the array is unique
+   and its last element is equal to `elem`, in which case the caller retains
+   ownership of `elem`.  Other duplicates are destroyed when the array is
+   sorted.
+*/
+ZixStatus
+lilv_array_insert(LilvArray* array, void* elem)
+{
+	const unsigned n = array->n_elems;
+	if (n > 0 && array->sorted) {
+		const int c = array->cmp(array->elems[n - 1], elem, NULL);
+		if (c == 0 && array->unique) {
+			return ZIX_STATUS_EXISTS;
+		} else if (c > 0) {
+			array->sorted = false;
+		}
+	}
+
+	if (n == array->capacity &&
+	    lilv_array_reserve(array, array->capacity ? array->capacity * 2 : 4)) {
+		return ZIX_STATUS_NO_MEM;
+	}
+
+	array->elems[n] = elem;
+	++array->n_elems;
+	return ZIX_STATUS_SUCCESS;
+}
+
+/** Return the element in `array` equal to `key`, or NULL. */
+static void*
+lilv_array_find(const LilvArray* array, const void* key)
+{
+	if (!(array = lilv_array_sorted(array))) {
+		return NULL;
+	}
+
+	// Binary search for the first element that sorts after `key`
+	unsigned lower = 0;
+	unsigned upper = array->n_elems;
+	while (lower < upper) {
+		const unsigned mid = lower + (upper - lower) / 2;
+		if (array->cmp(key, array->elems[mid], NULL) < 0) {
+			upper = mid;
+		} else {
+			lower = mid + 1;
+		}
+	}
+
+	if (lower > 0 && !array->cmp(array->elems[lower - 1], key, NULL)) {
+		return array->elems[lower - 1];
+	}
+	return NULL;
+}
+
 /* Constructors */
 
 LilvScalePoints*
 lilv_scale_points_new(void)
 {
-	return lilv_collection_new(lilv_ptr_cmp,
-	                           (ZixDestroyFunc)lilv_scale_point_free);
+	return lilv_array_new(
+		NULL, lilv_ptr_cmp, (ZixDestroyFunc)lilv_scale_point_free, true);
 }
 
 LilvNodes*
 lilv_nodes_new(void)
 {
-	return lilv_collection_new(lilv_ptr_cmp,
-	                           (ZixDestroyFunc)lilv_node_free);
+	// Nodes are interned, so the same node may be added several times
+	return lilv_array_new(
+		NULL, lilv_ptr_cmp, (ZixDestroyFunc)lilv_node_free, false);
 }
 
 LilvUIs*
 lilv_uis_new(void)
 {
-	return lilv_collection_new(lilv_header_compare_by_uri,
-	                           (ZixDestroyFunc)lilv_ui_free);
+	return lilv_array_new(
+		NULL, lilv_header_compare_by_uri, (ZixDestroyFunc)lilv_ui_free, true);
+}
+
+/**
+   Return a new collection for the results of a query.
+
+   If an arena is attached to the world, the collection is allocated from it
+   and the arena holds its node references, otherwise it owns a reference to
+   each node.
+*/
+LilvNodes*
+lilv_nodes_new_result(LilvWorld* world)
+{
+	return (world->arena
+	        ? lilv_array_new(world->arena, lilv_ptr_cmp, NULL, false)
+	        : lilv_nodes_new());
+}
+
+/**
+   Add `node` to a collection made by lilv_nodes_new_result().
+
+   This takes ownership of one reference to `node`, which is held by the
+   world's arena if one is attached.
+*/
+void
+lilv_nodes_add_result(LilvWorld* world, LilvNodes* nodes, LilvNode* node)
+{
+	if (node && world && world->arena) {
+		node = lilv_arena_hold(world->arena, node);
+	}
+	if (node) {
+		lilv_array_insert((LilvArray*)nodes, node);
+	}
+}
+
+/** Return a new collection of query results with the nodes of `a` and `b`. */
+LilvNodes*
+lilv_nodes_merge_result(LilvWorld*       world,
+                        const LilvNodes* a,
+                        const LilvNodes* b)
+{
+	LilvNodes* result = world ? lilv_nodes_new_result(world) : lilv_nodes_new();
+
+	LILV_FOREACH(nodes, i, a) {
+		lilv_nodes_add_result(
+			world, result, lilv_node_duplicate(lilv_nodes_get(a, i)));
+	}
+
+	LILV_FOREACH(nodes, i, b) {
+		lilv_nodes_add_result(
+			world, result, lilv_node_duplicate(lilv_nodes_get(b, i)));
+	}
+
+	return result;
+}
+
+/** Return a new collection of scale points for the results of a query. */
+LilvScalePoints*
+lilv_scale_points_new_result(LilvWorld* world)
+{
+	return (world->arena
+	        ? lilv_array_new(world->arena, lilv_ptr_cmp, NULL, true)
+	        : lilv_scale_points_new());
 }
 
 LilvPluginClasses*
@@ -104,12 +388,25 @@ lilv_plugin_classes_new(void)
 	                           (ZixDestroyFunc)lilv_plugin_class_free);
 }
 
+LilvPresets*
+lilv_presets_new(void)
+{
+	return lilv_collection_new(lilv_header_compare_by_uri,
+	                           (ZixDestroyFunc)lilv_preset_free);
+}
+
 /* URI based accessors (for collections of things with URIs) */
 
 LILV_API const LilvPluginClass*
 lilv_plugin_classes_get_by_uri(const LilvPluginClasses* classes,
                                const LilvNode*          uri)
 {
+	if (lilv_node_is_uri(uri) && classes == uri->world->plugin_classes) {
+		// Use the world's index, which is kept in sync with its classes
+		return (LilvPluginClass*)lilv_uri_index_find(
+			uri->world->classes_by_uri, uri->node);
+	}
+
 	return (LilvPluginClass*)lilv_collection_get_by_uri(
 		(const ZixTree*)classes, uri);
 }
@@ -117,7 +414,19 @@ lilv_plugin_classes_get_by_uri(const LilvPluginClasses* classes,
 LILV_API const LilvUI*
 lilv_uis_get_by_uri(const LilvUIs* uis, const LilvNode* uri)
 {
-	return (LilvUI*)lilv_collection_get_by_uri((const ZixTree*)uis, uri);
+	if (!lilv_node_is_uri(uri)) {
+		return NULL;
+	}
+
+	struct LilvHeader key = { NULL, (LilvNode*)uri };
+	return (LilvUI*)lilv_array_find((const LilvArray*)uis, &key);
+}
+
+LILV_API const LilvPreset*
+lilv_presets_get_by_uri(const LilvPresets* presets, const LilvNode* uri)
+{
+	return (LilvPreset*)lilv_collection_get_by_uri(
+		(const ZixTree*)presets, uri);
 }
 
 /* Plugins */
@@ -131,6 +440,12 @@ lilv_plugins_new(void)
 LILV_API const LilvPlugin*
 lilv_plugins_get_by_uri(const LilvPlugins* plugins, const LilvNode* uri)
 {
+	if (lilv_node_is_uri(uri) && plugins == uri->world->plugins) {
+		// Use the world's index, which is kept in sync with its plugins
+		return (LilvPlugin*)lilv_uri_index_find(
+			uri->world->plugins_by_uri, uri->node);
+	}
+
 	return (LilvPlugin*)lilv_collection_get_by_uri(
 		(const ZixTree*)plugins, uri);
 }
@@ -152,19 +467,13 @@ lilv_nodes_contains(const LilvNodes* nodes, const LilvNode* value)
 LILV_API LilvNodes*
 lilv_nodes_merge(const LilvNodes* a, const LilvNodes* b)
 {
-	LilvNodes* result = lilv_nodes_new();
-
-	LILV_FOREACH(nodes, i, a)
-		zix_tree_insert((ZixTree*)result,
-		                lilv_node_duplicate(lilv_nodes_get(a, i)),
-		                NULL);
-
-	LILV_FOREACH(nodes, i, b)
-		zix_tree_insert((ZixTree*)result,
-		                lilv_node_duplicate(lilv_nodes_get(b, i)),
-		                NULL);
+	// Allocate from the arena of the nodes' world, like query results
+	const LilvNode* first = lilv_nodes_get_first(a);
+	if (!first) {
+		first = lilv_nodes_get_first(b);
+	}
 
-	return result;
+	return lilv_nodes_merge_result(first ? first->world : NULL, a, b);
 }
 
 /* Iterator */
@@ -200,11 +509,53 @@ prefix##_is_end(const CT* collection, LilvIter* i) { \
 	return zix_tree_iter_is_end((ZixTreeIter*)i); \
 }
 
+#define LILV_ARRAY_COLLECTION_IMPL(prefix, CT, ET) \
+LILV_API \
+unsigned \
+prefix##_size(const CT* collection) { \
+	const LilvArray* array = lilv_array_sorted((const LilvArray*)collection); \
+	return array ? array->n_elems : 0; \
+} \
+\
+LILV_API \
+LilvIter* \
+prefix##_begin(const CT* collection) { \
+	const LilvArray* array = lilv_array_sorted((const LilvArray*)collection); \
+	return (array && array->n_elems) ? (LilvIter*)array->elems : NULL; \
+} \
+\
+LILV_API \
+const ET* \
+prefix##_get(const CT* collection, LilvIter* i) { \
+	return i ? (ET*)*(void**)i : NULL; \
+} \
+\
+LILV_API \
+LilvIter* \
+prefix##_next(const CT* collection, LilvIter* i) { \
+	const LilvArray* array = (const LilvArray*)collection; \
+	void** const     next  = (void**)i + 1; \
+	return (next < array->elems + array->n_elems) ? (LilvIter*)next : NULL; \
+} \
+\
+LILV_API \
+bool \
+prefix##_is_end(const CT* collection, LilvIter* i) { \
+	return !i; \
+} \
+\
+LILV_API \
+void \
+prefix##_free(CT* collection) { \
+	lilv_array_free((LilvArray*)collection); \
+}
+
 LILV_COLLECTION_IMPL(lilv_plugin_classes, LilvPluginClasses, LilvPluginClass)
-LILV_COLLECTION_IMPL(lilv_scale_points, LilvScalePoints, LilvScalePoint)
-LILV_COLLECTION_IMPL(lilv_uis, LilvUIs, LilvUI)
-LILV_COLLECTION_IMPL(lilv_nodes, LilvNodes, LilvNode)
+LILV_ARRAY_COLLECTION_IMPL(lilv_scale_points, LilvScalePoints, LilvScalePoint)
+LILV_ARRAY_COLLECTION_IMPL(lilv_uis, LilvUIs, LilvUI)
+LILV_ARRAY_COLLECTION_IMPL(lilv_nodes, LilvNodes, LilvNode)
 LILV_COLLECTION_IMPL(lilv_plugins, LilvPlugins, LilvPlugin)
+LILV_COLLECTION_IMPL(lilv_presets, LilvPresets, LilvPreset)
 
 LILV_API void
 lilv_plugin_classes_free(LilvPluginClasses* collection) {
@@ -212,22 +563,11 @@ lilv_plugin_classes_free(LilvPluginClasses* collection) {
 }
 
 LILV_API void
-lilv_scale_points_free(LilvScalePoints* collection) {
-	lilv_collection_free(collection);
-}
-
-LILV_API void
-lilv_uis_free(LilvUIs* collection) {
-	lilv_collection_free(collection);
-}
-
-LILV_API void
-lilv_nodes_free(LilvNodes* collection) {
+lilv_plugins_free(LilvPlugins* collection) {
 	lilv_collection_free(collection);
 }
 
 LILV_API LilvNode*
 lilv_nodes_get_first(const LilvNodes* collection) {
-	return (LilvNode*)lilv_collection_get(collection,
-	                                      lilv_collection_begin(collection));
+	return (LilvNode*)lilv_nodes_get(collection, lilv_nodes_begin(collection));
 }
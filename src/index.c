@@ -0,0 +1,473 @@
+/*
+  Copyright 2007-2019 David Robillard <http://drobilla.net>
+
+  Permission to use, copy, modify, and/or distribute this software for any
+  purpose with or without fee is hereby granted, provided that the above
+  copyright notice and this permission notice appear in all copies.
+
+  THIS SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+  WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+  MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+  ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+  WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+  ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+  OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+
+#define _POSIX_C_SOURCE 200809L  /* for fdopen, mkstemp */
+
+#include "lilv_config.h"
+#include "lilv_internal.h"
+
+#include "sord/sord.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef _WIN32
+#    include <io.h>
+#else
+#    include <unistd.h>
+#endif
+
+/*
+  The discovery index caches the statements of bundle manifests so that
+  unchanged bundles can be discovered without reading any Turtle.  The file
+  starts with a header line, followed by an entry for every bundle:
+
+    B <dev> <ino> <mtime> <ctime> <manifest ino> <manifest mtime>
+      <manifest ctime> <manifest size> <URI length> <data length>
+    <bundle URI>
+    <data>
+
+  The data is a sequence of statements, one per line, of three nodes.  Each
+  node is a type character (U, B, or L for URIs, blank nodes, and literals)
+  followed by the length of its string, a colon, and the null terminated
+  string.  Literals may be followed by a datatype node (^) or language (@) in
+  the same format.  Times are in nanoseconds.  Entries only depend on the
+  bundle directory and manifest, so data files do not affect their validity.
+*/
+
+#define LILV_INDEX_HEADER "lilv-discovery-index 3\n"
+
+LilvIndex*
+lilv_index_new(void)
+{
+	return (LilvIndex*)calloc(1, sizeof(LilvIndex));
+}
+
+void
+lilv_index_free(LilvIndex* index)
+{
+	if (index) {
+		for (size_t i = 0; i < index->n_entries; ++i) {
+			free(index->entries[i].uri);
+			free(index->entries[i].data);
+		}
+		free(index->entries);
+		free(index);
+	}
+}
+
+static int
+lilv_index_entry_cmp(const void* a, const void* b)
+{
+	return strcmp(((const LilvIndexEntry*)a)->uri,
+	              ((const LilvIndexEntry*)b)->uri);
+}
+
+void
+lilv_index_add(LilvIndex*             index,
+               const char*            bundle_uri,
+               const LilvBundleStamp* stamp,
+               const char*            data,
+               size_t                 len)
+{
+	index->entries = (LilvIndexEntry*)realloc(
+		index->entries, (index->n_entries + 1) * sizeof(LilvIndexEntry));
+
+	LilvIndexEntry* entry = &index->entries[index->n_entries++];
+	entry->uri   = lilv_strdup(bundle_uri);
+	entry->stamp = *stamp;
+	entry->data  = (char*)malloc(len + 1);
+	entry->len   = len;
+	memcpy(entry->data, data, len);
+	entry->data[len] = '\0';
+}
+
+/** Find the entry for a bundle in an index returned by lilv_index_read(). */
+const LilvIndexEntry*
+lilv_index_find(const LilvIndex* index, const char* bundle_uri)
+{
+	LilvIndexEntry key;
+	key.uri = (char*)bundle_uri;
+	return (const LilvIndexEntry*)bsearch(&key,
+	                                      index->entries,
+	                                      index->n_entries,
+	                                      sizeof(LilvIndexEntry),
+	                                      lilv_index_entry_cmp);
+}
+
+/** Read `len` bytes followed by a newline from `fd` to a new string. */
+static char*
+lilv_index_read_chunk(FILE* fd, size_t len)
+{
+	char* buf = (char*)malloc(len + 1);
+	if (fread(buf, 1, len, fd) != len || fgetc(fd) != '\n') {
+		free(buf);
+		return NULL;
+	}
+	buf[len] = '\0';
+	return buf;
+}
+
+LilvIndex*
+lilv_index_read(const char* path)
+{
+	FILE* fd = fopen(path, "rb");
+	if (!fd) {
+		return NULL;
+	}
+
+	char header[sizeof(LILV_INDEX_HEADER)];
+	if (!fgets(header, sizeof(header), fd) ||
+	    strcmp(header, LILV_INDEX_HEADER)) {
+		LILV_WARNF("Ignoring invalid discovery index `%s'\n", path);
+		fclose(fd);
+		return NULL;
+	}
+
+	LilvIndex* index = lilv_index_new();
+	bool       valid = true;
+	for (int c; valid && (c = fgetc(fd)) != EOF;) {
+		unsigned long long dev, ino, man_ino;
+		long long          mtime, ctime, man_mtime, man_ctime, man_size;
+		unsigned long long uri_len, data_len;
+		valid = (c == 'B' &&
+		         fscanf(fd,
+		                " %llu %llu %lld %lld %llu %lld %lld %lld %llu %llu",
+		                &dev, &ino, &mtime, &ctime,
+		                &man_ino, &man_mtime, &man_ctime, &man_size,
+		                &uri_len, &data_len) == 10 &&
+		         fgetc(fd) == '\n');
+		if (!valid) {
+			break;
+		}
+
+		char* uri  = lilv_index_read_chunk(fd, (size_t)uri_len);
+		char* data = uri ? lilv_index_read_chunk(fd, (size_t)data_len) : NULL;
+		if ((valid = (uri && data))) {
+			const LilvBundleStamp stamp = { (uint64_t)dev, (uint64_t)ino,
+			                                mtime, ctime, (uint64_t)man_ino,
+			                                man_mtime, man_ctime, man_size,
+			                                0, 0 };
+
+			lilv_index_add(index, uri, &stamp, data, (size_t)data_len);
+		}
+		free(data);
+		free(uri);
+	}
+
+	fclose(fd);
+	if (!valid) {
+		LILV_WARNF("Ignoring corrupt discovery index `%s'\n", path);
+		lilv_index_free(index);
+		return NULL;
+	}
+
+	qsort(index->entries, index->n_entries, sizeof(LilvIndexEntry),
+	      lilv_index_entry_cmp);
+	return index;
+}
+
+/** Create and open a new file from `path_template`, which ends in XXXXXX. */
+static FILE*
+lilv_index_open_temporary(char* path_template)
+{
+#ifdef _WIN32
+	return _mktemp(path_template) ? fopen(path_template, "wb") : NULL;
+#else
+	const int fd = mkstemp(path_template);
+	if (fd < 0) {
+		return NULL;
+	}
+
+	FILE* const file = fdopen(fd, "wb");
+	if (!file) {
+		close(fd);
+		remove(path_template);
+	}
+	return file;
+#endif
+}
+
+int
+lilv_index_write(LilvIndex* index, const char* path)
+{
+	char* dir = lilv_dirname(path);
+	lilv_mkdir_p(dir);
+	free(dir);
+
+	/* Write to a unique temporary file and rename it, so readers never see a
+	   partial index and concurrent writers do not clobber each other. */
+	char* tmp_path = lilv_strjoin(path, ".XXXXXX", NULL);
+	FILE* fd       = lilv_index_open_temporary(tmp_path);
+	if (!fd) {
+		LILV_ERRORF("Failed to open %s for writing\n", tmp_path);
+		free(tmp_path);
+		return 1;
+	}
+
+	qsort(index->entries, index->n_entries, sizeof(LilvIndexEntry),
+	      lilv_index_entry_cmp);
+
+	fputs(LILV_INDEX_HEADER, fd);
+	for (size_t i = 0; i < index->n_entries; ++i) {
+		const LilvIndexEntry*  entry = &index->entries[i];
+		const LilvBundleStamp* stamp = &entry->stamp;
+		fprintf(fd,
+		        "B %llu %llu %lld %lld %llu %lld %lld %lld %llu %llu\n",
+		        (unsigned long long)stamp->dev,
+		        (unsigned long long)stamp->ino,
+		        (long long)stamp->mtime,
+		        (long long)stamp->ctime,
+		        (unsigned long long)stamp->manifest_ino,
+		        (long long)stamp->manifest_mtime,
+		        (long long)stamp->manifest_ctime,
+		        (long long)stamp->manifest_size,
+		        (unsigned long long)strlen(entry->uri),
+		        (unsigned long long)entry->len);
+		fprintf(fd, "%s\n", entry->uri);
+		fwrite(entry->data, 1, entry->len, fd);
+		fputc('\n', fd);
+	}
+
+	const int st = ferror(fd) | fclose(fd);
+#ifdef _WIN32
+	remove(path);
+#endif
+	if (st || rename(tmp_path, path)) {
+		LILV_ERRORF("Failed to write discovery index %s\n", path);
+		remove(tmp_path);
+		free(tmp_path);
+		return 1;
+	}
+
+	free(tmp_path);
+	return 0;
+}
+
+char*
+lilv_index_default_path(void)
+{
+#ifdef _WIN32
+	const char* const cache = getenv("LOCALAPPDATA");
+	return cache ? lilv_path_join(cache, "lilv\\discovery-index") : NULL;
+#else
+	const char* const cache = getenv("XDG_CACHE_HOME");
+	const char* const home  = getenv("HOME");
+	if (cache && cache[0] == '/') {
+		return lilv_path_join(cache, "lilv/discovery-index");
+	}
+	return home ? lilv_path_join(home, ".cache/lilv/discovery-index") : NULL;
+#endif
+}
+
+typedef struct {
+	char*  buf;
+	size_t len;
+} LilvIndexBuffer;
+
+static void
+lilv_index_append(LilvIndexBuffer* buffer, const void* data, size_t len)
+{
+	buffer->buf = (char*)realloc(buffer->buf, buffer->len + len + 1);
+	memcpy(buffer->buf + buffer->len, data, len);
+	buffer->len += len;
+	buffer->buf[buffer->len] = '\0';
+}
+
+static void
+lilv_index_encode_string(LilvIndexBuffer* buffer, char type, const uint8_t* str)
+{
+	const size_t len = strlen((const char*)str);
+	char         head[32];
+	const int    head_len = snprintf(head, sizeof(head), "%c%zu:", type, len);
+
+	lilv_index_append(buffer, head, (size_t)head_len);
+	lilv_index_append(buffer, str, len + 1);
+}
+
+static void
+lilv_index_encode_node(LilvIndexBuffer* buffer, const SordNode* node)
+{
+	switch (sord_node_get_type(node)) {
+	case SORD_URI:
+		lilv_index_encode_string(buffer, 'U', sord_node_get_string(node));
+		break;
+	case SORD_BLANK:
+		lilv_index_encode_string(buffer, 'B', sord_node_get_string(node));
+		break;
+	case SORD_LITERAL:
+		lilv_index_encode_string(buffer, 'L', sord_node_get_string(node));
+		if (sord_node_get_datatype(node)) {
+			lilv_index_encode_string(
+				buffer, '^', sord_node_get_string(sord_node_get_datatype(node)));
+		} else if (sord_node_get_language(node)) {
+			lilv_index_encode_string(
+				buffer, '@', (const uint8_t*)sord_node_get_language(node));
+		}
+		break;
+	}
+}
+
+/** Encode all statements in `graph` as index data. */
+char*
+lilv_index_encode_graph(LilvWorld* world, const SordNode* graph, size_t* len)
+{
+	LilvIndexBuffer buffer = { NULL, 0 };
+	lilv_index_append(&buffer, "", 0);
+
+	SordIter* i = sord_search(world->model, NULL, NULL, NULL, graph);
+	FOREACH_MATCH(i) {
+		lilv_index_encode_node(&buffer, sord_iter_get_node(i, SORD_SUBJECT));
+		lilv_index_encode_node(&buffer, sord_iter_get_node(i, SORD_PREDICATE));
+		lilv_index_encode_node(&buffer, sord_iter_get_node(i, SORD_OBJECT));
+		lilv_index_append(&buffer, "\n", 1);
+	}
+	sord_iter_free(i);
+
+	*len = buffer.len;
+	return buffer.buf;
+}
+
+/** Decode a string of the given type at `*pos` and advance past it. */
+static const uint8_t*
+lilv_index_decode_string(const char** pos, const char* end, char type)
+{
+	if (*pos >= end || **pos != type) {
+		return NULL;
+	}
+
+	char*                    colon = NULL;
+	const unsigned long long len   = strtoull(*pos + 1, &colon, 10);
+	if (colon == *pos + 1 || *colon != ':' ||
+	    len >= (unsigned long long)(end - colon - 1) || colon[len + 1]) {
+		return NULL;
+	}
+
+	*pos = colon + len + 2;
+	return (const uint8_t*)colon + 1;
+}
+
+/**
+   Decode a node at `*pos` and advance past it.
+
+   If `world` is NULL, the node is only checked and a non-NULL dummy value is
+   returned on success.  Blank node labels are prefixed with `blank_prefix` to
+   keep them unique in the world.
+*/
+static SordNode*
+lilv_index_decode_node(LilvWorld*     world,
+                       const char**   pos,
+                       const char*    end,
+                       const uint8_t* blank_prefix)
+{
+	static char dummy = 0;
+
+	const char      type = *pos < end ? **pos : '\0';
+	const uint8_t*  str  = lilv_index_decode_string(pos, end, type);
+	const uint8_t*  dt   = NULL;
+	const uint8_t*  lang = NULL;
+	if (!str) {
+		return NULL;
+	} else if (type == 'L') {
+		if (*pos < end && **pos == '^') {
+			dt = lilv_index_decode_string(pos, end, '^');
+		} else if (*pos < end && **pos == '@') {
+			lang = lilv_index_decode_string(pos, end, '@');
+		}
+	} else if (type != 'U' && type != 'B') {
+		return NULL;
+	}
+
+	if (!world) {
+		return (SordNode*)&dummy;
+	}
+
+	SordNode* node = NULL;
+	if (type == 'U') {
+		node = sord_new_uri(world->world, str);
+	} else if (type == 'B') {
+		char* label = lilv_strjoin(
+			(const char*)blank_prefix, "_", (const char*)str, NULL);
+		node = sord_new_blank(world->world, (const uint8_t*)label);
+		free(label);
+	} else {
+		SordNode* datatype = dt ? sord_new_uri(world->world, dt) : NULL;
+		node = sord_new_literal(
+			world->world, datatype, str, (const char*)lang);
+		sord_node_free(world->world, datatype);
+	}
+
+	return node;
+}
+
+/** Decode all statements in `entry`, adding them to the model if `world`. */
+static bool
+lilv_index_decode(LilvWorld*            world,
+                  const LilvIndexEntry* entry,
+                  const SordNode*       graph,
+                  const uint8_t*        blank_prefix)
+{
+	const char*       pos = entry->data;
+	const char* const end = entry->data + entry->len;
+	while (pos < end) {
+		SordNode* s = lilv_index_decode_node(world, &pos, end, blank_prefix);
+		SordNode* p = s ? lilv_index_decode_node(world, &pos, end, blank_prefix) : NULL;
+		SordNode* o = p ? lilv_index_decode_node(world, &pos, end, blank_prefix) : NULL;
+		const bool valid = o && pos < end && *pos++ == '\n';
+		if (world) {
+			if (valid) {
+				const SordQuad quad = { s, p, o, graph };
+				sord_add(world->model, quad);
+			}
+			sord_node_free(world->world, o);
+			sord_node_free(world->world, p);
+			sord_node_free(world->world, s);
+		}
+
+		if (!valid) {
+			return false;
+		}
+	}
+	return true;
+}
+
+/**
+   Add the statements of an index entry to the world model in `graph`.
+
+   The entry is checked first, so nothing is added if it is corrupt.
+*/
+bool
+lilv_index_replay(LilvWorld*            world,
+                  const LilvIndexEntry* entry,
+                  const SordNode*       graph)
+{
+	if (!lilv_index_decode(NULL, entry, graph, NULL)) {
+		LILV_WARNF("Corrupt discovery index entry for <%s>\n", entry->uri);
+		return false;
+	}
+
+	// Blank nodes get a fresh prefix to avoid clashing with any in this world
+	uint8_t blank_prefix[32];
+	strncpy((char*)blank_prefix,
+	        (const char*)lilv_world_blank_node_prefix(world),
+	        sizeof(blank_prefix) - 1);
+	blank_prefix[sizeof(blank_prefix) - 1] = '\0';
+
+	return lilv_index_decode(world, entry, graph, blank_prefix);
+}
@@ -26,6 +26,7 @@ extern "C" {
 #include "lilv/lilv.h"
 #include "serd/serd.h"
 #include "sord/sord.h"
+#include "zix/hash.h"
 #include "zix/tree.h"
 
 #include <float.h>
@@ -71,8 +72,29 @@ static inline const char* dlerror(void) { return "Unknown error"; }
 
 typedef struct LilvSpecImpl LilvSpec;
 
+typedef struct LilvPortIndexImpl LilvPortIndex;
+
 typedef void LilvCollection;
 
+/**
+   A sorted array of elements.
+
+   This backs small collections that are built once and then only read
+   (LilvNodes, LilvUIs, and LilvScalePoints), so they take a single allocation
+   for their elements and iterate without chasing pointers.  Elements are
+   appended as the collection is built, and sorted once before it is read.
+*/
+typedef struct {
+	void**         elems;     ///< Elements, sorted by cmp if sorted is true
+	unsigned       n_elems;   ///< Number of elements
+	unsigned       capacity;  ///< Allocated size of elems
+	ZixComparator  cmp;       ///< Element comparator
+	ZixDestroyFunc destroy;   ///< Element destructor, or NULL
+	bool           unique;    ///< True iff equal elements are rejected
+	bool           sorted;    ///< True iff elems is sorted (and unique)
+	LilvArena*     arena;     ///< Arena the array is allocated from, or NULL
+} LilvArray;
+
 struct LilvPortImpl {
 	LilvNode*  node;     ///< RDF node
 	uint32_t   index;    ///< lv2:index
@@ -80,11 +102,38 @@ struct LilvPortImpl {
 	LilvNodes* classes;  ///< rdf:type
 };
 
+struct LilvPortTableImpl {
+	uint32_t         n_ports;
+	const LilvNode** symbols;       ///< Port symbols, shared with ports
+	uint32_t*        flags;         ///< LilvPortFlags
+	uint32_t*        properties;    ///< LilvPortPropertyFlags
+	float*           minimums;      ///< lv2:minimum, or NAN
+	float*           maximums;      ///< lv2:maximum, or NAN
+	float*           defaults;      ///< lv2:default, or NAN
+	LilvNode**       designations;  ///< lv2:designation, or NULL
+};
+
+typedef struct LilvVersion {
+	int minor;
+	int micro;
+} LilvVersion;
+
+struct LilvPluginSummaryImpl {
+	LilvNode*              name;          ///< doap:name, or NULL
+	const LilvPluginClass* plugin_class;  ///< Most specific known class
+	const LilvNode*        library_uri;   ///< lv2:binary, shared with plugin
+	LilvNode*              project;       ///< lv2:project, or NULL
+	LilvVersion            version;       ///< Version, or 0.0 if not given
+	bool                   complete;      ///< True iff read from all data
+};
+
 struct LilvSpecImpl {
 	SordNode*            spec;
 	SordNode*            bundle;
 	LilvNodes*           data_uris;
+	bool                 loaded;  ///< True iff data files have been loaded
 	struct LilvSpecImpl* next;
+	struct LilvSpecImpl* next_lazy;  ///< Next unloaded spec with the same URI
 };
 
 /**
@@ -128,16 +177,40 @@ struct LilvPluginImpl {
 	LilvNodes*             data_uris;  ///< rdfs::seeAlso
 	LilvPort**             ports;
 	uint32_t               num_ports;
+	LilvPortTable*         port_table;
+	LilvPluginSummary*     summary;
+	LilvUIs*               uis;           ///< UIs, or NULL if none
+	unsigned               uis_revision;  ///< World revision of uis
+	bool                   uis_loaded;
+	LilvPresets*           presets;           ///< Presets with URIs, or NULL
+	LilvNodes*             blank_presets;     ///< Presets that are blank nodes
+	unsigned               presets_revision;  ///< World revision of presets
+	bool                   presets_loaded;
+	LilvPortIndex*         ports_by_symbol;       ///< lv2:symbol index
+	LilvPortIndex*         ports_by_designation;  ///< lv2:designation index
+	LilvPortIndex*         ports_by_property;     ///< lv2:portProperty index
+	uint32_t               latency_port;  ///< Latency output index, or -1
+	bool                   has_latency;   ///< True iff a port reports latency
+	bool                   latency_loaded;
+	uint32_t*              required_features;  ///< Bitset of feature IDs
+	uint32_t               n_required_words;
+	bool                   features_loaded;
 	bool                   loaded;
 	bool                   parse_errors;
 	bool                   replaced;
+	LilvNode*              replaced_by;  ///< Known plugin that replaces this
 };
 
 struct LilvPluginClassImpl {
-	LilvWorld* world;
-	LilvNode*  uri;
-	LilvNode*  parent_uri;
-	LilvNode*  label;
+	LilvWorld*              world;
+	LilvNode*               uri;
+	LilvNode*               parent_uri;
+	LilvNode*               label;
+	const LilvPluginClass*  parent;      ///< Parent class, or NULL for roots
+	const LilvPluginClass** children;    ///< Direct subclasses, sorted by URI
+	unsigned                n_children;  ///< Number of direct subclasses
+	const LilvPluginClass** ancestors;   ///< Ancestors, from the root down
+	unsigned                depth;       ///< Number of ancestors
 };
 
 struct LilvInstancePimpl {
@@ -145,10 +218,38 @@ struct LilvInstancePimpl {
 	LilvLib*   lib;
 };
 
+/** File system state of a bundle, used to detect changes. */
+typedef struct {
+	uint64_t dev;             ///< Device of bundle directory
+	uint64_t ino;             ///< Inode of bundle directory
+	int64_t  mtime;           ///< Modification time of bundle directory in ns
+	int64_t  ctime;           ///< Status change time of bundle directory in ns
+	uint64_t manifest_ino;    ///< Inode of manifest.ttl
+	int64_t  manifest_mtime;  ///< Modification time of manifest.ttl in ns
+	int64_t  manifest_ctime;  ///< Status change time of manifest.ttl in ns
+	int64_t  manifest_size;   ///< Size of manifest.ttl
+	int64_t  data_mtime;      ///< Newest modification time in bundle in ns
+	int64_t  data_ctime;      ///< Newest status change time in bundle in ns
+} LilvBundleStamp;
+
+/** A bundle discovered in LV2_PATH, and its state when it was loaded. */
+typedef struct {
+	LilvNode*       uri;      ///< Bundle URI
+	LilvBundleStamp stamp;    ///< Bundle state, including data files
+	int64_t         time;     ///< Time when loading started in ns
+	bool            stamped;  ///< True iff stamp is valid
+	bool            loaded;   ///< True iff the manifest was loaded
+} LilvBundleRecord;
+
+typedef struct LilvWatcherImpl LilvWatcher;
+
 typedef struct {
-	bool  dyn_manifest;
-	bool  filter_language;
-	char* lv2_path;
+	bool     dyn_manifest;
+	bool     filter_language;
+	char*    lv2_path;
+	unsigned discovery_threads;
+	char*    index_path;
+	bool     lazy_specs;
 } LilvOptions;
 
 struct LilvWorldImpl {
@@ -161,20 +262,51 @@ struct LilvWorldImpl {
 	LilvSpec*          specs;
 	LilvPlugins*       plugins;
 	LilvPlugins*       zombies;
-	LilvNodes*         loaded_files;
+	ZixHash*           plugins_by_uri;  ///< LilvUriEntry for each plugin
+	ZixHash*           zombies_by_uri;  ///< LilvUriEntry for each zombie
+	ZixHash*           classes_by_uri;  ///< LilvUriEntry for each class
+	ZixTree*           loaded_files;  ///< LilvNode for each loaded file
 	ZixTree*           libs;
+	LilvBundleRecord*  bundles;  ///< Discovered bundles, sorted by URI
+	size_t             n_bundles;
+	LilvWatcher*       watcher;
+	ZixTree*           versions;  ///< LilvVersionTable for each bundle
+	ZixTree*           bundle_files;  ///< LilvBundleFiles for each bundle
+	bool               classes_loaded;  ///< False if lazily deferred
+	unsigned           revision;  ///< Incremented when data is loaded or dropped
+	LilvPluginClass**  all_classes;  ///< Plugin classes, as an array
+	size_t             n_classes;
+	ZixHash*           feature_ids;  ///< LilvFeatureId for each known feature
+	ZixHash*           lazy_specs;  ///< LilvLazySpecs for each unloaded spec URI
+	ZixHash*           nodes;  ///< Interned LilvNode for each SordNode
+	LilvArena*         arena;  ///< Allocator for query results, or NULL
+	uint32_t*          supported_features;  ///< Bitset of host feature IDs
+	uint32_t           n_supported_words;
+	char*              env_lang;  ///< LANG that lang was converted from
+	char*              lang;      ///< System language for filtering, or NULL
 	struct {
+		SordNode* atom_AtomPort;
 		SordNode* dc_replaces;
 		SordNode* dman_DynManifest;
 		SordNode* doap_name;
+		SordNode* ev_EventPort;
+		SordNode* lv2_AudioPort;
+		SordNode* lv2_CVPort;
+		SordNode* lv2_ControlPort;
+		SordNode* lv2_InputPort;
+		SordNode* lv2_OutputPort;
 		SordNode* lv2_Plugin;
 		SordNode* lv2_Specification;
 		SordNode* lv2_appliesTo;
 		SordNode* lv2_binary;
+		SordNode* lv2_connectionOptional;
 		SordNode* lv2_default;
 		SordNode* lv2_designation;
+		SordNode* lv2_enumeration;
 		SordNode* lv2_extensionData;
 		SordNode* lv2_index;
+		SordNode* lv2_integer;
+		SordNode* lv2_isSideChain;
 		SordNode* lv2_latency;
 		SordNode* lv2_maximum;
 		SordNode* lv2_microVersion;
@@ -184,11 +316,21 @@ struct LilvWorldImpl {
 		SordNode* lv2_optionalFeature;
 		SordNode* lv2_port;
 		SordNode* lv2_portProperty;
+		SordNode* lv2_project;
 		SordNode* lv2_reportsLatency;
 		SordNode* lv2_requiredFeature;
+		SordNode* lv2_sampleRate;
 		SordNode* lv2_symbol;
+		SordNode* lv2_toggled;
 		SordNode* lv2_prototype;
 		SordNode* owl_Ontology;
+		SordNode* pprops_causesArtifacts;
+		SordNode* pprops_expensive;
+		SordNode* pprops_logarithmic;
+		SordNode* pprops_notOnGUI;
+		SordNode* pprops_trigger;
+		SordNode* pset_Preset;
+		SordNode* pset_bank;
 		SordNode* pset_value;
 		SordNode* rdf_a;
 		SordNode* rdf_value;
@@ -196,6 +338,8 @@ struct LilvWorldImpl {
 		SordNode* rdfs_label;
 		SordNode* rdfs_seeAlso;
 		SordNode* rdfs_subClassOf;
+		SordNode* ui_binary;
+		SordNode* ui_ui;
 		SordNode* xsd_base64Binary;
 		SordNode* xsd_boolean;
 		SordNode* xsd_decimal;
@@ -220,6 +364,8 @@ struct LilvNodeImpl {
 	LilvWorld*   world;
 	SordNode*    node;
 	LilvNodeType type;
+	unsigned     refs;      ///< Reference count
+	bool         interned;  ///< True iff stored in world->nodes
 	union {
 		int   int_val;
 		float float_val;
@@ -232,6 +378,14 @@ struct LilvScalePointImpl {
 	LilvNode* label;
 };
 
+struct LilvPresetImpl {
+	LilvWorld* world;
+	LilvNode*  uri;
+	LilvNode*  label;     ///< rdfs:label, or NULL
+	LilvNode*  bank;      ///< pset:bank, or NULL
+	unsigned   revision;  ///< World revision the preset was last found in
+};
+
 struct LilvUIImpl {
 	LilvWorld* world;
 	LilvNode*  uri;
@@ -240,10 +394,47 @@ struct LilvUIImpl {
 	LilvNodes* classes;
 };
 
-typedef struct LilvVersion {
-	int minor;
-	int micro;
-} LilvVersion;
+/** The version of a plugin in some bundle. */
+typedef struct {
+	LilvNode*   plugin;   ///< Plugin URI
+	LilvVersion version;  ///< Version, or 0.0 if not given
+} LilvPluginVersion;
+
+/** Versions of the plugins in a bundle, used to resolve conflicts. */
+typedef struct {
+	LilvNode*          bundle;     ///< Bundle URI
+	LilvPluginVersion* plugins;    ///< Plugin versions, sorted by plugin node
+	size_t             n_plugins;  ///< Number of plugins
+} LilvVersionTable;
+
+/** Files loaded from inside a bundle, which are unloaded with it. */
+typedef struct {
+	char*      uri;    ///< Bundle URI
+	ZixTree*   files;  ///< Loaded files inside the bundle
+} LilvBundleFiles;
+
+/** Cached manifest statements of a bundle in a discovery index. */
+typedef struct {
+	char*           uri;    ///< Bundle URI
+	LilvBundleStamp stamp;  ///< Bundle state when entry was made
+	char*           data;   ///< Encoded manifest statements
+	size_t          len;    ///< Length of data in bytes
+} LilvIndexEntry;
+
+/** On-disk discovery index, a set of entries sorted by bundle URI. */
+typedef struct {
+	LilvIndexEntry* entries;
+	size_t          n_entries;
+} LilvIndex;
+
+/** A Turtle file to be parsed into a private model, possibly in a thread. */
+typedef struct {
+	const LilvNode* uri;               ///< File URI, or NULL to skip
+	uint8_t         blank_prefix[32];  ///< Blank node prefix for file
+	SordWorld*      world;             ///< Private node world
+	SordModel*      model;             ///< Private model of parsed statements
+	SerdStatus      status;            ///< Parse status
+} LilvParseJob;
 
 /*
  *
@@ -262,6 +453,7 @@ LilvPlugin* lilv_plugin_new(LilvWorld* world,
                             LilvNode*  bundle_uri);
 void        lilv_plugin_clear(LilvPlugin* plugin, LilvNode* bundle_uri);
 void        lilv_plugin_load_if_necessary(const LilvPlugin* plugin);
+bool        lilv_plugin_is_hostable(const LilvPlugin* plugin);
 void        lilv_plugin_free(LilvPlugin* plugin);
 LilvNode*   lilv_plugin_get_unique(const LilvPlugin* plugin,
                                    const SordNode*   subject,
@@ -273,12 +465,40 @@ LilvIter* lilv_collection_begin(const LilvCollection* collection);
 void*     lilv_collection_get(const LilvCollection* collection,
                               const LilvIter*       i);
 
+ZixStatus lilv_array_insert(LilvArray* array, void* elem);
+
+void*     lilv_arena_alloc(LilvArena* arena, size_t size);
+LilvNode* lilv_arena_hold(LilvArena* arena, LilvNode* node);
+
 LilvPluginClass* lilv_plugin_class_new(LilvWorld*      world,
                                        const SordNode* parent_node,
                                        const SordNode* uri,
                                        const char*     label);
 
 void lilv_plugin_class_free(LilvPluginClass* plugin_class);
+LilvVersion lilv_world_get_version(LilvWorld*      world,
+                                   const LilvNode* bundle_uri,
+                                   const LilvNode* plugin_uri);
+
+LilvPortTable* lilv_port_table_new(const LilvPlugin* plugin);
+void           lilv_port_table_free(LilvPortTable* table);
+
+LilvPortIndex* lilv_port_index_new(const LilvPlugin* plugin,
+                                   const SordNode*   predicate);
+void           lilv_port_index_free(LilvPortIndex* index);
+
+LilvPort* const* lilv_port_index_find(const LilvPortIndex* index,
+                                      const SordNode*      value,
+                                      uint32_t*            n_ports);
+void lilv_plugin_class_clear_tree(LilvPluginClass* plugin_class);
+
+const LilvPluginClass*
+lilv_world_find_plugin_class(const LilvWorld* world, const SordNode* uri);
+
+void* lilv_uri_index_find(const ZixHash* index, const SordNode* uri);
+
+bool
+lilv_world_get_feature_id(LilvWorld* world, const SordNode* uri, uint32_t* id);
 
 LilvLib*
 lilv_lib_open(LilvWorld*               world,
@@ -293,8 +513,18 @@ LilvNodes*         lilv_nodes_new(void);
 LilvPlugins*       lilv_plugins_new(void);
 LilvScalePoints*   lilv_scale_points_new(void);
 LilvPluginClasses* lilv_plugin_classes_new(void);
+LilvPresets*       lilv_presets_new(void);
 LilvUIs*           lilv_uis_new(void);
 
+LilvNodes*       lilv_nodes_new_result(LilvWorld* world);
+void             lilv_nodes_add_result(LilvWorld* world,
+                                       LilvNodes* nodes,
+                                       LilvNode*  node);
+LilvNodes*       lilv_nodes_merge_result(LilvWorld*       world,
+                                         const LilvNodes* a,
+                                         const LilvNodes* b);
+LilvScalePoints* lilv_scale_points_new_result(LilvWorld* world);
+
 LilvNode* lilv_world_get_manifest_uri(LilvWorld*      world,
                                       const LilvNode* bundle_uri);
 
@@ -309,20 +539,76 @@ lilv_world_load_graph(LilvWorld*      world,
                       SordNode*       graph,
                       const LilvNode* uri);
 
+void lilv_parse_job_init(LilvParseJob*   job,
+                         const LilvNode* uri,
+                         const uint8_t*  blank_prefix);
+
+void lilv_parse_jobs_run(LilvParseJob* jobs, size_t n_jobs, unsigned n_threads);
+
+void lilv_parse_job_merge(const LilvParseJob* job,
+                          SordWorld*          world,
+                          SordModel*          model,
+                          const SordNode*     graph);
+
+void lilv_parse_job_clear(LilvParseJob* job);
+
+SerdStatus lilv_reader_read_file(SerdReader* reader, const uint8_t* uri);
+
+LilvWatcher* lilv_watcher_new(char** dirs, size_t n_dirs, unsigned quiet_ms);
+void         lilv_watcher_free(LilvWatcher* watcher);
+bool         lilv_watcher_has_changes(LilvWatcher* watcher);
+char**       lilv_watcher_take_changes(LilvWatcher* watcher, size_t* n_paths);
+
+LilvIndex* lilv_index_new(void);
+LilvIndex* lilv_index_read(const char* path);
+int        lilv_index_write(LilvIndex* index, const char* path);
+void       lilv_index_free(LilvIndex* index);
+
+const LilvIndexEntry*
+lilv_index_find(const LilvIndex* index, const char* bundle_uri);
+
+void lilv_index_add(LilvIndex*             index,
+                    const char*            bundle_uri,
+                    const LilvBundleStamp* stamp,
+                    const char*            data,
+                    size_t                 len);
+
+char* lilv_index_encode_graph(LilvWorld*      world,
+                              const SordNode* graph,
+                              size_t*         len);
+
+bool lilv_index_replay(LilvWorld*            world,
+                       const LilvIndexEntry* entry,
+                       const SordNode*       graph);
+
+char* lilv_index_default_path(void);
+
 LilvUI* lilv_ui_new(LilvWorld* world,
                     LilvNode*  uri,
                     LilvNode*  type_uri,
                     LilvNode*  binary_uri);
 
-void lilv_ui_free(LilvUI* ui);
+LilvUI* lilv_ui_duplicate(const LilvUI* ui);
+void    lilv_ui_free(LilvUI* ui);
+void lilv_version_table_free(LilvVersionTable* table);
+void lilv_bundle_files_free(LilvBundleFiles* files);
 
 LilvNode* lilv_node_new(LilvWorld* world, LilvNodeType type, const char* str);
 LilvNode* lilv_node_new_from_node(LilvWorld* world, const SordNode* node);
 
 int lilv_header_compare_by_uri(const void* a, const void* b, void* user_data);
 int lilv_lib_compare(const void* a, const void* b, void* user_data);
+int lilv_version_table_cmp(const void* a, const void* b, void* user_data);
+int lilv_bundle_files_cmp(const void* a, const void* b, void* user_data);
 
 int lilv_ptr_cmp(const void* a, const void* b, void* user_data);
+
+/** Return a well-distributed hash of a pointer, like an interned node. */
+static inline uint32_t
+lilv_ptr_hash(const void* ptr)
+{
+	return (uint32_t)(((uint64_t)(uintptr_t)ptr * 0x9E3779B97F4A7C15ull) >> 32);
+}
 int lilv_resource_node_cmp(const void* a, const void* b, void* user_data);
 
 static inline int
@@ -342,8 +628,21 @@ struct LilvHeader*
 lilv_collection_get_by_uri(const ZixTree* seq, const LilvNode* uri);
 
 LilvScalePoint* lilv_scale_point_new(LilvNode* value, LilvNode* label);
+LilvScalePoint* lilv_scale_point_new_in(LilvArena*      arena,
+                                        const LilvNode* value,
+                                        const LilvNode* label);
 void            lilv_scale_point_free(LilvScalePoint* point);
 
+LilvPreset* lilv_preset_new(LilvWorld* world,
+                            LilvNode*  uri,
+                            LilvNode*  label,
+                            LilvNode*  bank);
+
+void lilv_preset_free(LilvPreset* preset);
+
+void lilv_world_load_specs_for(LilvWorld* world, const SordNode* node);
+void lilv_world_load_classes_if_necessary(LilvWorld* world);
+
 SordIter*
 lilv_world_query_internal(LilvWorld*      world,
                           const SordNode* subject,
@@ -377,13 +676,21 @@ LilvNodes* lilv_nodes_from_stream_objects(LilvWorld*    world,
                                           SordIter*     stream,
                                           SordQuadIndex field);
 
+LilvQuery* lilv_query_new(LilvWorld*    world,
+                          SordIter*     stream,
+                          SordQuadIndex field);
+
 char*  lilv_strjoin(const char* first, ...);
 char*  lilv_strdup(const char* str);
+void   lilv_bitset_set(uint32_t** bits, uint32_t* n_words, uint32_t bit);
 char*  lilv_get_lang(void);
+
+const char* lilv_world_get_lang(LilvWorld* world);
 char*  lilv_expand(const char* path);
 char*  lilv_dirname(const char* path);
 int    lilv_copy_file(const char* src, const char* dst);
 bool   lilv_path_exists(const char* path, const void* ignored);
+bool   lilv_is_directory(const char* path);
 char*  lilv_path_absolute(const char* path);
 bool   lilv_path_is_absolute(const char* path);
 char*  lilv_get_latest_copy(const char* path, const char* copy_path);
@@ -395,6 +702,15 @@ int    lilv_symlink(const char* oldpath, const char* newpath);
 int    lilv_mkdir_p(const char* dir_path);
 char*  lilv_path_join(const char* a, const char* b);
 bool   lilv_file_equals(const char* a_path, const char* b_path);
+int    lilv_bundle_stamp(const char*      bundle_path,
+                         bool             data,
+                         LilvBundleStamp* stamp);
+bool   lilv_bundle_manifest_stamp_equals(const LilvBundleStamp* a,
+                                         const LilvBundleStamp* b);
+bool   lilv_bundle_stamp_equals(const LilvBundleStamp* a,
+                                const LilvBundleStamp* b);
+int64_t lilv_bundle_stamp_newest(const LilvBundleStamp* stamp);
+int64_t lilv_current_time(void);
 
 char*
 lilv_find_free_path(const char* in_path,
@@ -19,6 +19,8 @@
 #include "lilv/lilv.h"
 #include "serd/serd.h"
 #include "sord/sord.h"
+#include "zix/common.h"
+#include "zix/hash.h"
 
 #include <math.h>
 #include <stdbool.h>
@@ -50,53 +52,75 @@ lilv_node_set_numerics_from_string(LilvNode* val)
 	}
 }
 
-/** Note that if `type` is numeric or boolean, the returned value is corrupt
- * until lilv_node_set_numerics_from_string is called.  It is not
- * automatically called from here to avoid overhead and imprecision when the
- * exact string value is known.
- */
+/**
+   Return the interned node for `node`, creating it if necessary.
+
+   This takes ownership of one reference to `node`.  Every distinct sord node
+   has at most one interned LilvNode per world, so numeric values are only
+   parsed once, and duplicating or freeing a node only changes its reference
+   count.
+*/
+static LilvNode*
+lilv_node_intern(LilvWorld* world, SordNode* node, LilvNodeType type)
+{
+	LilvNode key;
+	key.world    = world;
+	key.node     = node;
+	key.type     = type;
+	key.refs     = 1;
+	key.interned = true;
+
+	LilvNode*       result = NULL;
+	const ZixStatus st     = zix_hash_insert(
+		world->nodes, &key, (void**)&result);
+
+	if (st == ZIX_STATUS_EXISTS) {
+		sord_node_free(world->world, node);  // Already held by interned node
+		++result->refs;
+	} else if (st) {
+		sord_node_free(world->world, node);
+		return NULL;
+	} else {
+		lilv_node_set_numerics_from_string(result);
+	}
+
+	return result;
+}
+
 LilvNode*
 lilv_node_new(LilvWorld* world, LilvNodeType type, const char* str)
 {
-	LilvNode* val = (LilvNode*)malloc(sizeof(LilvNode));
-	val->world = world;
-	val->type  = type;
-
 	const uint8_t* ustr = (const uint8_t*)str;
+	SordNode*      node = NULL;
 	switch (type) {
 	case LILV_VALUE_URI:
-		val->node = sord_new_uri(world->world, ustr);
+		node = sord_new_uri(world->world, ustr);
 		break;
 	case LILV_VALUE_BLANK:
-		val->node = sord_new_blank(world->world, ustr);
+		node = sord_new_blank(world->world, ustr);
 		break;
 	case LILV_VALUE_STRING:
-		val->node = sord_new_literal(world->world, NULL, ustr, NULL);
+		node = sord_new_literal(world->world, NULL, ustr, NULL);
 		break;
 	case LILV_VALUE_INT:
-		val->node = sord_new_literal(
+		node = sord_new_literal(
 			world->world, world->uris.xsd_integer, ustr, NULL);
 		break;
 	case LILV_VALUE_FLOAT:
-		val->node = sord_new_literal(
+		node = sord_new_literal(
 			world->world, world->uris.xsd_decimal, ustr, NULL);
 		break;
 	case LILV_VALUE_BOOL:
-		val->node = sord_new_literal(
+		node = sord_new_literal(
 			world->world, world->uris.xsd_boolean, ustr, NULL);
 		break;
 	case LILV_VALUE_BLOB:
-		val->node = sord_new_literal(
+		node = sord_new_literal(
 			world->world, world->uris.xsd_base64Binary, ustr, NULL);
 		break;
 	}
 
-	if (!val->node) {
-		free(val);
-		return NULL;
-	}
-
-	return val;
+	return node ? lilv_node_intern(world, node, type) : NULL;
 }
 
 /** Create a new LilvNode from `node`, or return NULL if impossible */
@@ -107,22 +131,25 @@ lilv_node_new_from_node(LilvWorld* world, const SordNode* node)
 		return NULL;
 	}
 
-	LilvNode*    result       = NULL;
+	// Fast path for nodes that have already been interned
+	LilvNode key;
+	key.node = (SordNode*)node;
+
+	LilvNode* result = (LilvNode*)zix_hash_find(world->nodes, &key);
+	if (result) {
+		++result->refs;
+		return result;
+	}
+
 	SordNode*    datatype_uri = NULL;
 	LilvNodeType type         = LILV_VALUE_STRING;
 
 	switch (sord_node_get_type(node)) {
 	case SORD_URI:
-		result        = (LilvNode*)malloc(sizeof(LilvNode));
-		result->world = world;
-		result->type  = LILV_VALUE_URI;
-		result->node  = sord_node_copy(node);
+		result = lilv_node_intern(world, sord_node_copy(node), LILV_VALUE_URI);
 		break;
 	case SORD_BLANK:
-		result        = (LilvNode*)malloc(sizeof(LilvNode));
-		result->world = world;
-		result->type  = LILV_VALUE_BLANK;
-		result->node  = sord_node_copy(node);
+		result = lilv_node_intern(world, sord_node_copy(node), LILV_VALUE_BLANK);
 		break;
 	case SORD_LITERAL:
 		datatype_uri = sord_node_get_datatype(node);
@@ -144,7 +171,6 @@ lilv_node_new_from_node(LilvWorld* world, const SordNode* node)
 		}
 		result = lilv_node_new(
 			world, type, (const char*)sord_node_get_string(node));
-		lilv_node_set_numerics_from_string(result);
 		break;
 	}
 
@@ -181,9 +207,7 @@ lilv_new_int(LilvWorld* world, int val)
 {
 	char str[32];
 	snprintf(str, sizeof(str), "%d", val);
-	LilvNode* ret = lilv_node_new(world, LILV_VALUE_INT, str);
-	ret->val.int_val = val;
-	return ret;
+	return lilv_node_new(world, LILV_VALUE_INT, str);
 }
 
 LILV_API LilvNode*
@@ -192,17 +216,24 @@ lilv_new_float(LilvWorld* world, float val)
 	char str[32];
 	snprintf(str, sizeof(str), "%f", val);
 	LilvNode* ret = lilv_node_new(world, LILV_VALUE_FLOAT, str);
-	ret->val.float_val = val;
+	if (ret && ret->val.float_val != val) {
+		// String is rounded, so keep the exact value in a private node
+		LilvNode* exact = (LilvNode*)malloc(sizeof(LilvNode));
+		*exact               = *ret;
+		exact->node          = sord_node_copy(ret->node);
+		exact->refs          = 1;
+		exact->interned      = false;
+		exact->val.float_val = val;
+		lilv_node_free(ret);
+		ret = exact;
+	}
 	return ret;
 }
 
 LILV_API LilvNode*
 lilv_new_bool(LilvWorld* world, bool val)
 {
-	LilvNode* ret = lilv_node_new(world, LILV_VALUE_BOOL,
-	                              val ? "true" : "false");
-	ret->val.bool_val = val;
-	return ret;
+	return lilv_node_new(world, LILV_VALUE_BOOL, val ? "true" : "false");
 }
 
 LILV_API LilvNode*
@@ -212,27 +243,30 @@ lilv_node_duplicate(const LilvNode* val)
 		return NULL;
 	}
 
-	LilvNode* result = (LilvNode*)malloc(sizeof(LilvNode));
-	result->world = val->world;
-	result->node  = sord_node_copy(val->node);
-	result->val   = val->val;
-	result->type  = val->type;
+	LilvNode* result = (LilvNode*)val;
+	++result->refs;
 	return result;
 }
 
 LILV_API void
 lilv_node_free(LilvNode* val)
 {
-	if (val) {
-		sord_node_free(val->world->world, val->node);
-		free(val);
+	if (val && --val->refs == 0) {
+		LilvWorld* const world = val->world;
+		SordNode* const  node  = val->node;
+		if (val->interned) {
+			zix_hash_remove(world->nodes, val);
+		} else {
+			free(val);
+		}
+		sord_node_free(world->world, node);
 	}
 }
 
 LILV_API bool
 lilv_node_equals(const LilvNode* value, const LilvNode* other)
 {
-	if (value == NULL && other == NULL) {
+	if (value == other) {
 		return true;
 	} else if (value == NULL || other == NULL) {
 		return false;
@@ -245,7 +279,7 @@ lilv_node_equals(const LilvNode* value, const LilvNode* other)
 	case LILV_VALUE_BLANK:
 	case LILV_VALUE_STRING:
 	case LILV_VALUE_BLOB:
-		return sord_node_equals(value->node, other->node);
+		return false;  // Interned, so equal nodes are identical
 	case LILV_VALUE_INT:
 		return (value->val.int_val == other->val.int_val);
 	case LILV_VALUE_FLOAT:
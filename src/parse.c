@@ -0,0 +1,213 @@
+/*
+  Copyright 2007-2019 David Robillard <http://drobilla.net>
+
+  Permission to use, copy, modify, and/or distribute this software for any
+  purpose with or without fee is hereby granted, provided that the above
+  copyright notice and this permission notice appear in all copies.
+
+  THIS SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+  WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+  MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+  ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+  WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+  ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+  OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+
+#include "lilv_config.h"
+#include "lilv_internal.h"
+
+#include "serd/serd.h"
+#include "sord/sord.h"
+
+#ifdef HAVE_PTHREAD
+#    include <pthread.h>
+#endif
+
+#include <stdlib.h>
+#include <string.h>
+
+/*
+  Parse jobs read a Turtle file into a private sord world and model, which
+  touches no shared state and is therefore safe to do in any thread.  The
+  results are later merged into the world model by the main thread, which
+  keeps all interning and bookkeeping single-threaded and lets the caller
+  decide the order in which results become visible.
+*/
+
+void
+lilv_parse_job_init(LilvParseJob*   job,
+                    const LilvNode* uri,
+                    const uint8_t*  blank_prefix)
+{
+	memset(job, 0, sizeof(LilvParseJob));
+	job->uri = uri;
+	strncpy((char*)job->blank_prefix, (const char*)blank_prefix,
+	        sizeof(job->blank_prefix) - 1);
+}
+
+static void
+lilv_parse_job_execute(LilvParseJob* job)
+{
+	const uint8_t* uri_str = sord_node_get_string(job->uri->node);
+	const SerdNode base    = serd_node_from_string(SERD_URI, uri_str);
+
+	job->world = sord_world_new();
+	job->model = sord_new(job->world, SORD_SPO, false);
+
+	SerdEnv*    env    = serd_env_new(&base);
+	SerdReader* reader = sord_new_reader(job->model, env, SERD_TURTLE, NULL);
+
+	serd_reader_add_blank_prefix(reader, job->blank_prefix);
+	job->status = lilv_reader_read_file(reader, uri_str);
+
+	serd_reader_free(reader);
+	serd_env_free(env);
+}
+
+#ifdef HAVE_PTHREAD
+
+typedef struct {
+	LilvParseJob*   jobs;
+	size_t          n_jobs;
+	size_t          next;
+	pthread_mutex_t mutex;
+} LilvParseQueue;
+
+static LilvParseJob*
+lilv_parse_queue_pop(LilvParseQueue* queue)
+{
+	LilvParseJob* job = NULL;
+
+	pthread_mutex_lock(&queue->mutex);
+	while (queue->next < queue->n_jobs && !job) {
+		LilvParseJob* const next = &queue->jobs[queue->next++];
+		if (next->uri) {
+			job = next;
+		}
+	}
+	pthread_mutex_unlock(&queue->mutex);
+
+	return job;
+}
+
+static void*
+lilv_parse_thread(void* data)
+{
+	LilvParseQueue* queue = (LilvParseQueue*)data;
+	for (LilvParseJob* job; (job = lilv_parse_queue_pop(queue));) {
+		lilv_parse_job_execute(job);
+	}
+	return NULL;
+}
+
+#endif  // HAVE_PTHREAD
+
+void
+lilv_parse_jobs_run(LilvParseJob* jobs, size_t n_jobs, unsigned n_threads)
+{
+#ifdef HAVE_PTHREAD
+	if (n_threads > n_jobs) {
+		n_threads = (unsigned)n_jobs;
+	}
+
+	if (n_threads > 1) {
+		LilvParseQueue queue;
+		queue.jobs   = jobs;
+		queue.n_jobs = n_jobs;
+		queue.next   = 0;
+		pthread_mutex_init(&queue.mutex, NULL);
+
+		// Launch workers, the calling thread is the first worker
+		pthread_t* threads   = (pthread_t*)calloc(n_threads, sizeof(pthread_t));
+		unsigned   n_started = 0;
+		for (unsigned i = 1; i < n_threads; ++i) {
+			if (pthread_create(&threads[n_started], NULL,
+			                   lilv_parse_thread, &queue)) {
+				LILV_WARNF("Failed to start parse thread %u\n", i);
+				break;
+			}
+			++n_started;
+		}
+
+		lilv_parse_thread(&queue);
+		for (unsigned i = 0; i < n_started; ++i) {
+			pthread_join(threads[i], NULL);
+		}
+
+		pthread_mutex_destroy(&queue.mutex);
+		free(threads);
+		return;
+	}
+#endif
+
+	for (size_t i = 0; i < n_jobs; ++i) {
+		if (jobs[i].uri) {
+			lilv_parse_job_execute(&jobs[i]);
+		}
+	}
+}
+
+/** Return an equivalent of `node` (from another sord world) in `world`. */
+static SordNode*
+lilv_parse_import_node(SordWorld* world, const SordNode* node)
+{
+	const uint8_t* str = sord_node_get_string(node);
+	switch (sord_node_get_type(node)) {
+	case SORD_URI:
+		return sord_new_uri(world, str);
+	case SORD_BLANK:
+		return sord_new_blank(world, str);
+	case SORD_LITERAL: {
+		const SordNode* datatype = sord_node_get_datatype(node);
+		SordNode*       type     = datatype
+			? sord_new_uri(world, sord_node_get_string(datatype))
+			: NULL;
+		SordNode* literal = sord_new_literal(
+			world, type, str, sord_node_get_language(node));
+		sord_node_free(world, type);
+		return literal;
+	}
+	}
+	return NULL;
+}
+
+void
+lilv_parse_job_merge(const LilvParseJob* job,
+                     SordWorld*          world,
+                     SordModel*          model,
+                     const SordNode*     graph)
+{
+	if (!job->model) {
+		return;
+	}
+
+	SordIter* i = sord_begin(job->model);
+	for (; !sord_iter_end(i); sord_iter_next(i)) {
+		SordNode* s = lilv_parse_import_node(
+			world, sord_iter_get_node(i, SORD_SUBJECT));
+		SordNode* p = lilv_parse_import_node(
+			world, sord_iter_get_node(i, SORD_PREDICATE));
+		SordNode* o = lilv_parse_import_node(
+			world, sord_iter_get_node(i, SORD_OBJECT));
+
+		const SordQuad quad = { s, p, o, graph };
+		sord_add(model, quad);
+
+		sord_node_free(world, o);
+		sord_node_free(world, p);
+		sord_node_free(world, s);
+	}
+	sord_iter_free(i);
+}
+
+void
+lilv_parse_job_clear(LilvParseJob* job)
+{
+	if (job->world) {
+		sord_free(job->model);
+		sord_world_free(job->world);
+	}
+	job->model = NULL;
+	job->world = NULL;
+}
@@ -25,14 +25,12 @@
 #include "zix/tree.h"
 
 #include "lv2/core/lv2.h"
-#include "lv2/ui/ui.h"
 
 #ifdef LILV_DYN_MANIFEST
 #    include "lv2/dynmanifest/dynmanifest.h"
 #    include <dlfcn.h>
 #endif
 
-#include <math.h>
 #include <stdarg.h>
 #include <stdbool.h>
 #include <stdint.h>
@@ -55,9 +53,30 @@ lilv_plugin_init(LilvPlugin* plugin, LilvNode* bundle_uri)
 	plugin->data_uris    = lilv_nodes_new();
 	plugin->ports        = NULL;
 	plugin->num_ports    = 0;
+	plugin->port_table   = NULL;
+	plugin->summary      = NULL;
+	plugin->uis          = NULL;
+	plugin->uis_revision = 0;
+	plugin->uis_loaded   = false;
+
+	plugin->presets          = NULL;
+	plugin->blank_presets    = NULL;
+	plugin->presets_revision = 0;
+	plugin->presets_loaded   = false;
 	plugin->loaded       = false;
 	plugin->parse_errors = false;
 	plugin->replaced     = false;
+	plugin->replaced_by  = NULL;
+
+	plugin->ports_by_symbol      = NULL;
+	plugin->ports_by_designation = NULL;
+	plugin->ports_by_property    = NULL;
+	plugin->latency_port         = (uint32_t)-1;
+	plugin->has_latency          = false;
+	plugin->latency_loaded       = false;
+	plugin->required_features    = NULL;
+	plugin->n_required_words     = 0;
+	plugin->features_loaded      = false;
 }
 
 /** Ownership of `uri` and `bundle` is taken */
@@ -73,18 +92,29 @@ lilv_plugin_new(LilvWorld* world, LilvNode* uri, LilvNode* bundle_uri)
 	return plugin;
 }
 
-void
-lilv_plugin_clear(LilvPlugin* plugin, LilvNode* bundle_uri)
+static void
+lilv_plugin_summary_free(LilvPluginSummary* summary)
 {
-	lilv_node_free(plugin->bundle_uri);
-	lilv_node_free(plugin->binary_uri);
-	lilv_nodes_free(plugin->data_uris);
-	lilv_plugin_init(plugin, bundle_uri);
+	if (summary) {
+		lilv_node_free(summary->name);
+		lilv_node_free(summary->project);
+		free(summary);
+	}
 }
 
 static void
 lilv_plugin_free_ports(LilvPlugin* plugin)
 {
+	lilv_port_table_free(plugin->port_table);
+	lilv_port_index_free(plugin->ports_by_symbol);
+	lilv_port_index_free(plugin->ports_by_designation);
+	lilv_port_index_free(plugin->ports_by_property);
+	plugin->port_table           = NULL;
+	plugin->ports_by_symbol      = NULL;
+	plugin->ports_by_designation = NULL;
+	plugin->ports_by_property    = NULL;
+	plugin->latency_loaded       = false;
+
 	if (plugin->ports) {
 		for (uint32_t i = 0; i < plugin->num_ports; ++i) {
 			lilv_port_free(plugin, plugin->ports[i]);
@@ -95,6 +125,22 @@ lilv_plugin_free_ports(LilvPlugin* plugin)
 	}
 }
 
+void
+lilv_plugin_clear(LilvPlugin* plugin, LilvNode* bundle_uri)
+{
+	lilv_node_free(plugin->bundle_uri);
+	lilv_node_free(plugin->binary_uri);
+	lilv_node_free(plugin->replaced_by);
+	lilv_nodes_free(plugin->data_uris);
+	free(plugin->required_features);
+	lilv_plugin_summary_free(plugin->summary);
+	lilv_uis_free(plugin->uis);
+	lilv_collection_free(plugin->presets);
+	lilv_nodes_free(plugin->blank_presets);
+	lilv_plugin_free_ports(plugin);
+	lilv_plugin_init(plugin, bundle_uri);
+}
+
 void
 lilv_plugin_free(LilvPlugin* plugin)
 {
@@ -122,11 +168,29 @@ lilv_plugin_free(LilvPlugin* plugin)
 	lilv_node_free(plugin->binary_uri);
 	plugin->binary_uri = NULL;
 
+	lilv_node_free(plugin->replaced_by);
+	plugin->replaced_by = NULL;
+
 	lilv_plugin_free_ports(plugin);
 
 	lilv_nodes_free(plugin->data_uris);
 	plugin->data_uris = NULL;
 
+	free(plugin->required_features);
+	plugin->required_features = NULL;
+
+	lilv_plugin_summary_free(plugin->summary);
+	plugin->summary = NULL;
+
+	lilv_uis_free(plugin->uis);
+	plugin->uis = NULL;
+
+	lilv_collection_free(plugin->presets);
+	plugin->presets = NULL;
+
+	lilv_nodes_free(plugin->blank_presets);
+	plugin->blank_presets = NULL;
+
 	free(plugin);
 }
 
@@ -170,42 +234,47 @@ lilv_plugin_load(LilvPlugin* plugin)
 	SerdReader* reader = sord_new_reader(plugin->world->model, env, SERD_TURTLE,
 	                                     bundle_uri_node);
 
-	SordModel* prots = lilv_world_filter_model(
+	// Collect prototypes first, since statements are added while expanding
+	const SordNode** prototypes   = NULL;
+	size_t           n_prototypes = 0;
+	SordIter*        p            = lilv_world_query_internal(
 		plugin->world,
-		plugin->world->model,
 		plugin->plugin_uri->node,
 		plugin->world->uris.lv2_prototype,
-		NULL, NULL);
-	SordModel* skel = sord_new(plugin->world->world, SORD_SPO, false);
-	SordIter*  iter = sord_begin(prots);
-	for (; !sord_iter_end(iter); sord_iter_next(iter)) {
-		const SordNode* t         = sord_iter_get_node(iter, SORD_OBJECT);
-		LilvNode*       prototype = lilv_node_new_from_node(plugin->world, t);
+		NULL);
+	FOREACH_MATCH(p) {
+		prototypes = (const SordNode**)realloc(
+			prototypes, (n_prototypes + 1) * sizeof(const SordNode*));
+		prototypes[n_prototypes++] = sord_iter_get_node(p, SORD_OBJECT);
+	}
+	sord_iter_free(p);
 
+	// Add the statements of each prototype about this plugin
+	for (size_t i = 0; i < n_prototypes; ++i) {
+		LilvNode* prototype = lilv_node_new_from_node(plugin->world,
+		                                              prototypes[i]);
 		lilv_world_load_resource(plugin->world, prototype);
 
-		SordIter* statements = sord_search(
-			plugin->world->model, prototype->node, NULL, NULL, NULL);
-		FOREACH_MATCH(statements) {
-			SordQuad quad;
-			sord_iter_get(statements, quad);
-			quad[0] = plugin->plugin_uri->node;
-			sord_add(skel, quad);
+		// Collect statements first, since adding invalidates the iterator
+		SordQuad* quads   = NULL;
+		size_t    n_quads = 0;
+		SordIter* s       = sord_search(
+			plugin->world->model, prototypes[i], NULL, NULL, NULL);
+		FOREACH_MATCH(s) {
+			quads = (SordQuad*)realloc(quads, (n_quads + 1) * sizeof(SordQuad));
+			sord_iter_get(s, quads[n_quads]);
+			quads[n_quads++][SORD_SUBJECT] = plugin->plugin_uri->node;
 		}
+		sord_iter_free(s);
 
-		sord_iter_free(statements);
-		lilv_node_free(prototype);
-	}
-	sord_iter_free(iter);
+		for (size_t q = 0; q < n_quads; ++q) {
+			sord_add(plugin->world->model, quads[q]);
+		}
 
-	for (iter = sord_begin(skel); !sord_iter_end(iter); sord_iter_next(iter)) {
-		SordQuad quad;
-		sord_iter_get(iter, quad);
-		sord_add(plugin->world->model, quad);
+		free(quads);
+		lilv_node_free(prototype);
 	}
-	sord_iter_free(iter);
-	sord_free(skel);
-	sord_free(prots);
+	free(prototypes);
 
 	// Parse all the plugin's data files into RDF model
 	SerdStatus st = SERD_SUCCESS;
@@ -340,9 +409,9 @@ lilv_plugin_load_ports_if_necessary(const LilvPlugin* const_plugin)
 			FOREACH_MATCH(types) {
 				const SordNode* type = sord_iter_get_node(types, SORD_OBJECT);
 				if (sord_node_get_type(type) == SORD_URI) {
-					zix_tree_insert(
-						(ZixTree*)this_port->classes,
-						lilv_node_new_from_node(plugin->world, type), NULL);
+					lilv_array_insert(
+						(LilvArray*)this_port->classes,
+						lilv_node_new_from_node(plugin->world, type));
 				} else {
 					LILV_WARNF("Plugin <%s> port type is not a URI\n",
 					           lilv_node_as_uri(plugin->plugin_uri));
@@ -364,6 +433,11 @@ lilv_plugin_load_ports_if_necessary(const LilvPlugin* const_plugin)
 				break;
 			}
 		}
+
+		/* Build the port table here rather than on first use, so it is not
+		   written by a getter on a plugin that is otherwise already loaded. */
+		lilv_port_table_free(plugin->port_table);
+		plugin->port_table = lilv_port_table_new(plugin);
 	}
 }
 
@@ -387,10 +461,10 @@ lilv_plugin_get_bundle_uri(const LilvPlugin* plugin)
 	return plugin->bundle_uri;
 }
 
-LILV_API const LilvNode*
-lilv_plugin_get_library_uri(const LilvPlugin* plugin)
+/** Set the binary URI of `plugin` from loaded data if it is not yet known. */
+static void
+lilv_plugin_find_binary(LilvPlugin* plugin)
 {
-	lilv_plugin_load_if_necessary((LilvPlugin*)plugin);
 	if (!plugin->binary_uri) {
 		// <plugin> lv2:binary ?binary
 		SordIter* i = lilv_world_query_internal(plugin->world,
@@ -400,13 +474,20 @@ lilv_plugin_get_library_uri(const LilvPlugin* plugin)
 		FOREACH_MATCH(i) {
 			const SordNode* binary_node = sord_iter_get_node(i, SORD_OBJECT);
 			if (sord_node_get_type(binary_node) == SORD_URI) {
-				((LilvPlugin*)plugin)->binary_uri =
+				plugin->binary_uri =
 					lilv_node_new_from_node(plugin->world, binary_node);
 				break;
 			}
 		}
 		sord_iter_free(i);
 	}
+}
+
+LILV_API const LilvNode*
+lilv_plugin_get_library_uri(const LilvPlugin* plugin)
+{
+	lilv_plugin_load_if_necessary((LilvPlugin*)plugin);
+	lilv_plugin_find_binary((LilvPlugin*)plugin);
 	if (!plugin->binary_uri) {
 		LILV_WARNF("Plugin <%s> has no lv2:binary\n",
 		           lilv_node_as_uri(lilv_plugin_get_uri(plugin)));
@@ -420,42 +501,46 @@ lilv_plugin_get_data_uris(const LilvPlugin* plugin)
 	return plugin->data_uris;
 }
 
+/** Return the first specific known class of `plugin` in loaded data. */
+static const LilvPluginClass*
+lilv_plugin_find_class(const LilvPlugin* plugin)
+{
+	const LilvPluginClass* pclass = NULL;
+
+	// <plugin> a ?class
+	SordIter* c = lilv_world_query_internal(plugin->world,
+	                                        plugin->plugin_uri->node,
+	                                        plugin->world->uris.rdf_a,
+	                                        NULL);
+	FOREACH_MATCH(c) {
+		const SordNode* class_node = sord_iter_get_node(c, SORD_OBJECT);
+		if (sord_node_get_type(class_node) != SORD_URI) {
+			continue;
+		}
+
+		if (class_node != plugin->world->lv2_plugin_class->uri->node) {
+			pclass = lilv_world_find_plugin_class(plugin->world, class_node);
+			if (pclass) {
+				break;
+			}
+		}
+	}
+	sord_iter_free(c);
+
+	return pclass;
+}
+
 LILV_API const LilvPluginClass*
 lilv_plugin_get_class(const LilvPlugin* plugin)
 {
 	lilv_plugin_load_if_necessary((LilvPlugin*)plugin);
 	if (!plugin->plugin_class) {
-		// <plugin> a ?class
-		SordIter* c = lilv_world_query_internal(plugin->world,
-		                                        plugin->plugin_uri->node,
-		                                        plugin->world->uris.rdf_a,
-		                                        NULL);
-		FOREACH_MATCH(c) {
-			const SordNode* class_node = sord_iter_get_node(c, SORD_OBJECT);
-			if (sord_node_get_type(class_node) != SORD_URI) {
-				continue;
-			}
+		lilv_world_load_classes_if_necessary(plugin->world);
 
-			LilvNode* klass = lilv_node_new_from_node(plugin->world, class_node);
-			if (!lilv_node_equals(klass, plugin->world->lv2_plugin_class->uri)) {
-				const LilvPluginClass* pclass = lilv_plugin_classes_get_by_uri(
-					plugin->world->plugin_classes, klass);
+		const LilvPluginClass* pclass = lilv_plugin_find_class(plugin);
 
-				if (pclass) {
-					((LilvPlugin*)plugin)->plugin_class = pclass;
-					lilv_node_free(klass);
-					break;
-				}
-			}
-
-			lilv_node_free(klass);
-		}
-		sord_iter_free(c);
-
-		if (plugin->plugin_class == NULL) {
-			((LilvPlugin*)plugin)->plugin_class =
-				plugin->world->lv2_plugin_class;
-		}
+		((LilvPlugin*)plugin)->plugin_class =
+			pclass ? pclass : plugin->world->lv2_plugin_class;
 	}
 	return plugin->plugin_class;
 }
@@ -503,11 +588,13 @@ lilv_plugin_verify(const LilvPlugin* plugin)
 	return true;
 }
 
-LILV_API LilvNode*
-lilv_plugin_get_name(const LilvPlugin* plugin)
+/** Return the name of `plugin` in loaded data, or NULL. */
+static LilvNode*
+lilv_plugin_find_name(const LilvPlugin* plugin)
 {
-	LilvNodes* results = lilv_plugin_get_value_internal(
-		plugin, plugin->world->uris.doap_name);
+	LilvWorld* world   = plugin->world;
+	LilvNodes* results = lilv_world_find_nodes_internal(
+		world, plugin->plugin_uri->node, world->uris.doap_name, NULL);
 
 	LilvNode* ret = NULL;
 	if (results) {
@@ -518,6 +605,15 @@ lilv_plugin_get_name(const LilvPlugin* plugin)
 		lilv_nodes_free(results);
 	}
 
+	return ret;
+}
+
+LILV_API LilvNode*
+lilv_plugin_get_name(const LilvPlugin* plugin)
+{
+	lilv_plugin_load_if_necessary(plugin);
+
+	LilvNode* ret = lilv_plugin_find_name(plugin);
 	if (!ret) {
 		LILV_WARNF("Plugin <%s> has no (mandatory) doap:name\n",
 		           lilv_node_as_string(lilv_plugin_get_uri(plugin)));
@@ -526,6 +622,97 @@ lilv_plugin_get_name(const LilvPlugin* plugin)
 	return ret;
 }
 
+LILV_API const LilvPluginSummary*
+lilv_plugin_get_summary(const LilvPlugin* plugin)
+{
+	LilvPlugin* const  p       = (LilvPlugin*)plugin;
+	LilvPluginSummary* summary = p->summary;
+	if (summary && (summary->complete || !plugin->loaded)) {
+		return summary;
+	}
+
+	LilvWorld* const world = plugin->world;
+	lilv_world_load_classes_if_necessary(world);
+
+	if (!summary) {
+		// Try the data loaded so far, which is usually only the manifest
+		LilvNode*              name   = lilv_plugin_find_name(plugin);
+		const LilvPluginClass* pclass = lilv_plugin_find_class(plugin);
+		lilv_plugin_find_binary(p);
+
+		if (!plugin->loaded && (!name || !pclass || !plugin->binary_uri)) {
+			// Something is only in the plugin data files, so fall back to loading
+			lilv_plugin_load_if_necessary(plugin);
+		}
+
+		summary = (LilvPluginSummary*)calloc(1, sizeof(LilvPluginSummary));
+		summary->name         = name;
+		summary->plugin_class = pclass ? pclass : world->lv2_plugin_class;
+		summary->project      = lilv_plugin_get_one(
+			plugin, plugin->plugin_uri->node, world->uris.lv2_project);
+		summary->version      = lilv_world_get_version(
+			world, plugin->bundle_uri, plugin->plugin_uri);
+
+		p->summary = summary;
+	}
+
+	if (plugin->loaded) {
+		// Fill in anything that is only in the data files, which are loaded now
+		if (!summary->name) {
+			summary->name = lilv_plugin_find_name(plugin);
+		}
+		if (summary->plugin_class == world->lv2_plugin_class) {
+			const LilvPluginClass* pclass = lilv_plugin_find_class(plugin);
+			summary->plugin_class = pclass ? pclass : world->lv2_plugin_class;
+		}
+		if (!summary->project) {
+			summary->project = lilv_plugin_get_one(
+				plugin, plugin->plugin_uri->node, world->uris.lv2_project);
+		}
+		lilv_plugin_find_binary(p);
+		summary->complete = true;
+	}
+
+	summary->library_uri = plugin->binary_uri;
+	return summary;
+}
+
+LILV_API const LilvNode*
+lilv_plugin_summary_get_name(const LilvPluginSummary* summary)
+{
+	return summary->name;
+}
+
+LILV_API const LilvPluginClass*
+lilv_plugin_summary_get_class(const LilvPluginSummary* summary)
+{
+	return summary->plugin_class;
+}
+
+LILV_API const LilvNode*
+lilv_plugin_summary_get_library_uri(const LilvPluginSummary* summary)
+{
+	return summary->library_uri;
+}
+
+LILV_API const LilvNode*
+lilv_plugin_summary_get_project(const LilvPluginSummary* summary)
+{
+	return summary->project;
+}
+
+LILV_API int
+lilv_plugin_summary_get_minor_version(const LilvPluginSummary* summary)
+{
+	return summary->version.minor;
+}
+
+LILV_API int
+lilv_plugin_summary_get_micro_version(const LilvPluginSummary* summary)
+{
+	return summary->version.micro;
+}
+
 LILV_API LilvNodes*
 lilv_plugin_get_value(const LilvPlugin* plugin,
                       const LilvNode*   predicate)
@@ -534,6 +721,14 @@ lilv_plugin_get_value(const LilvPlugin* plugin,
 	return lilv_world_find_nodes(plugin->world, plugin->plugin_uri, predicate, NULL);
 }
 
+LILV_API LilvQuery*
+lilv_plugin_query_value(const LilvPlugin* plugin,
+                        const LilvNode*   predicate)
+{
+	lilv_plugin_load_if_necessary(plugin);
+	return lilv_world_query(plugin->world, plugin->plugin_uri, predicate, NULL);
+}
+
 LILV_API uint32_t
 lilv_plugin_get_num_ports(const LilvPlugin* plugin)
 {
@@ -547,44 +742,20 @@ lilv_plugin_get_port_ranges_float(const LilvPlugin* plugin,
                                   float*            max_values,
                                   float*            def_values)
 {
-	lilv_plugin_load_ports_if_necessary(plugin);
-	LilvNode*  min    = NULL;
-	LilvNode*  max    = NULL;
-	LilvNode*  def    = NULL;
-	LilvNode** minptr = min_values ? &min : NULL;
-	LilvNode** maxptr = max_values ? &max : NULL;
-	LilvNode** defptr = def_values ? &def : NULL;
-
-	for (uint32_t i = 0; i < plugin->num_ports; ++i) {
-		lilv_port_get_range(plugin, plugin->ports[i], defptr, minptr, maxptr);
-
-		if (min_values) {
-			if (lilv_node_is_float(min) || lilv_node_is_int(min)) {
-				min_values[i] = lilv_node_as_float(min);
-			} else {
-				min_values[i] = NAN;
-			}
-		}
+	// Copy from the port table, which reads all ranges in a single scan
+	const LilvPortTable* table = lilv_plugin_get_port_table(plugin);
+	const size_t         size  = table->n_ports * sizeof(float);
 
-		if (max_values) {
-			if (lilv_node_is_float(max) || lilv_node_is_int(max)) {
-				max_values[i] = lilv_node_as_float(max);
-			} else {
-				max_values[i] = NAN;
-			}
-		}
+	if (min_values && size) {
+		memcpy(min_values, table->minimums, size);
+	}
 
-		if (def_values) {
-			if (lilv_node_is_float(def) || lilv_node_is_int(def)) {
-				def_values[i] = lilv_node_as_float(def);
-			} else {
-				def_values[i] = NAN;
-			}
-		}
+	if (max_values && size) {
+		memcpy(max_values, table->maximums, size);
+	}
 
-		lilv_node_free(def);
-		lilv_node_free(min);
-		lilv_node_free(max);
+	if (def_values && size) {
+		memcpy(def_values, table->defaults, size);
 	}
 }
 
@@ -641,64 +812,33 @@ lilv_plugin_get_num_ports_of_class(const LilvPlugin* plugin,
 	return count;
 }
 
-LILV_API bool
-lilv_plugin_has_latency(const LilvPlugin* plugin)
+/** Return `*index`, building it from statements with `predicate` if needed. */
+static const LilvPortIndex*
+lilv_plugin_get_port_index(const LilvPlugin* plugin,
+                           LilvPortIndex**   index,
+                           const SordNode*   predicate)
 {
-	lilv_plugin_load_if_necessary(plugin);
-	SordIter* ports = lilv_world_query_internal(
-		plugin->world,
-		plugin->plugin_uri->node,
-		plugin->world->uris.lv2_port,
-		NULL);
-
-	bool ret = false;
-	FOREACH_MATCH(ports) {
-		const SordNode* port = sord_iter_get_node(ports, SORD_OBJECT);
-		SordIter*       prop = lilv_world_query_internal(
-			plugin->world,
-			port,
-			plugin->world->uris.lv2_portProperty,
-			plugin->world->uris.lv2_reportsLatency);
-		SordIter* des = lilv_world_query_internal(
-			plugin->world,
-			port,
-			plugin->world->uris.lv2_designation,
-			plugin->world->uris.lv2_latency);
-		const bool latent = !sord_iter_end(prop) || !sord_iter_end(des);
-		sord_iter_free(prop);
-		sord_iter_free(des);
-		if (latent) {
-			ret = true;
-			break;
-		}
+	lilv_plugin_load_ports_if_necessary(plugin);
+	if (!*index) {
+		*index = lilv_port_index_new(plugin, predicate);
 	}
-	sord_iter_free(ports);
-
-	return ret;
+	return *index;
 }
 
 static const LilvPort*
 lilv_plugin_get_port_by_property(const LilvPlugin* plugin,
                                  const SordNode*   port_property)
 {
-	lilv_plugin_load_ports_if_necessary(plugin);
-	for (uint32_t i = 0; i < plugin->num_ports; ++i) {
-		LilvPort* port = plugin->ports[i];
-		SordIter* iter = lilv_world_query_internal(
-			plugin->world,
-			port->node->node,
-			plugin->world->uris.lv2_portProperty,
-			port_property);
+	const LilvPortIndex* index = lilv_plugin_get_port_index(
+		plugin,
+		&((LilvPlugin*)plugin)->ports_by_property,
+		plugin->world->uris.lv2_portProperty);
 
-		const bool found = !sord_iter_end(iter);
-		sord_iter_free(iter);
+	uint32_t               n_ports = 0;
+	LilvPort* const* const ports   = lilv_port_index_find(
+		index, port_property, &n_ports);
 
-		if (found) {
-			return port;
-		}
-	}
-
-	return NULL;
+	return n_ports ? ports[0] : NULL;
 }
 
 LILV_API const LilvPort*
@@ -706,51 +846,92 @@ lilv_plugin_get_port_by_designation(const LilvPlugin* plugin,
                                     const LilvNode*   port_class,
                                     const LilvNode*   designation)
 {
-	LilvWorld* world = plugin->world;
-	lilv_plugin_load_ports_if_necessary(plugin);
-	for (uint32_t i = 0; i < plugin->num_ports; ++i) {
-		LilvPort* port = plugin->ports[i];
-		SordIter* iter = lilv_world_query_internal(
-			world,
-			port->node->node,
-			world->uris.lv2_designation,
-			designation->node);
-
-		const bool found = !sord_iter_end(iter) &&
-			(!port_class || lilv_port_is_a(plugin, port, port_class));
-		sord_iter_free(iter);
-
-		if (found) {
-			return port;
+	const LilvPortIndex* index = lilv_plugin_get_port_index(
+		plugin,
+		&((LilvPlugin*)plugin)->ports_by_designation,
+		plugin->world->uris.lv2_designation);
+
+	uint32_t               n_ports = 0;
+	LilvPort* const* const ports   = lilv_port_index_find(
+		index, designation->node, &n_ports);
+
+	for (uint32_t i = 0; i < n_ports; ++i) {
+		if (!port_class || lilv_port_is_a(plugin, ports[i], port_class)) {
+			return ports[i];
 		}
 	}
 
 	return NULL;
 }
 
-LILV_API uint32_t
-lilv_plugin_get_latency_port_index(const LilvPlugin* plugin)
+LILV_API const LilvPortTable*
+lilv_plugin_get_port_table(const LilvPlugin* plugin)
+{
+	lilv_plugin_load_ports_if_necessary(plugin);
+	return plugin->port_table;
+}
+
+static bool
+lilv_port_is_output(const LilvPlugin* plugin, const LilvPort* port)
+{
+	LILV_FOREACH(nodes, c, port->classes) {
+		const LilvNode* port_class = lilv_nodes_get(port->classes, c);
+		if (port_class->node == plugin->world->uris.lv2_OutputPort) {
+			return true;
+		}
+	}
+	return false;
+}
+
+/** Find the latency port once, since hosts ask for it frequently. */
+static void
+lilv_plugin_load_latency_if_necessary(const LilvPlugin* plugin)
 {
-	LilvNode* lv2_OutputPort =
-		lilv_new_uri(plugin->world, LV2_CORE__OutputPort);
-	LilvNode* lv2_latency =
-		lilv_new_uri(plugin->world, LV2_CORE__latency);
+	if (plugin->latency_loaded) {
+		return;
+	}
 
+	LilvPlugin* const p     = (LilvPlugin*)plugin;
+	LilvWorld* const  world = plugin->world;
+
+	// A port with lv2:portProperty lv2:reportsLatency takes precedence
 	const LilvPort* prop_port = lilv_plugin_get_port_by_property(
-		plugin, plugin->world->uris.lv2_reportsLatency);
-	const LilvPort* des_port = lilv_plugin_get_port_by_designation(
-		plugin, lv2_OutputPort, lv2_latency);
+		plugin, world->uris.lv2_reportsLatency);
 
-	lilv_node_free(lv2_latency);
-	lilv_node_free(lv2_OutputPort);
+	// Otherwise, use the first output port with lv2:designation lv2:latency
+	const LilvPortIndex* index = lilv_plugin_get_port_index(
+		plugin, &p->ports_by_designation, world->uris.lv2_designation);
 
-	if (prop_port) {
-		return prop_port->index;
-	} else if (des_port) {
-		return des_port->index;
-	} else {
-		return (uint32_t)-1;
+	uint32_t               n_des     = 0;
+	LilvPort* const* const des_ports = lilv_port_index_find(
+		index, world->uris.lv2_latency, &n_des);
+
+	const LilvPort* des_port = NULL;
+	for (uint32_t i = 0; i < n_des && !des_port; ++i) {
+		if (lilv_port_is_output(plugin, des_ports[i])) {
+			des_port = des_ports[i];
+		}
 	}
+
+	p->has_latency    = prop_port || n_des > 0;
+	p->latency_port   = (prop_port  ? prop_port->index
+	                     : des_port ? des_port->index
+	                                : (uint32_t)-1);
+	p->latency_loaded = true;
+}
+
+LILV_API bool
+lilv_plugin_has_latency(const LilvPlugin* plugin)
+{
+	lilv_plugin_load_latency_if_necessary(plugin);
+	return plugin->has_latency;
+}
+
+LILV_API uint32_t
+lilv_plugin_get_latency_port_index(const LilvPlugin* plugin)
+{
+	lilv_plugin_load_latency_if_necessary(plugin);
+	return plugin->latency_port;
 }
 
 LILV_API bool
@@ -771,12 +952,61 @@ lilv_plugin_has_feature(const LilvPlugin* plugin,
 	return false;
 }
 
+/** Build the bitset of required feature IDs once, for fast filtering. */
+static void
+lilv_plugin_load_features_if_necessary(const LilvPlugin* plugin)
+{
+	if (plugin->features_loaded) {
+		return;
+	}
+
+	lilv_plugin_load_if_necessary(plugin);
+
+	LilvPlugin* const p        = (LilvPlugin*)plugin;
+	LilvWorld* const  world    = plugin->world;
+	bool              complete = true;
+	SordIter*         f        = lilv_world_query_internal(
+		world, plugin->plugin_uri->node, world->uris.lv2_requiredFeature, NULL);
+	FOREACH_MATCH(f) {
+		const SordNode* uri = sord_iter_get_node(f, SORD_OBJECT);
+		uint32_t        id  = 0;
+		if (lilv_world_get_feature_id(world, uri, &id)) {
+			lilv_bitset_set(&p->required_features, &p->n_required_words, id);
+		} else {
+			complete = false;
+		}
+	}
+	sord_iter_free(f);
+
+	p->features_loaded = complete;
+}
+
+bool
+lilv_plugin_is_hostable(const LilvPlugin* plugin)
+{
+	lilv_plugin_load_features_if_necessary(plugin);
+	if (!plugin->features_loaded) {
+		return false;  // Failed to allocate an ID for some required feature
+	}
+
+	const LilvWorld* world = plugin->world;
+	for (uint32_t i = 0; i < plugin->n_required_words; ++i) {
+		const uint32_t supported = (i < world->n_supported_words)
+			? world->supported_features[i] : 0;
+		if (plugin->required_features[i] & ~supported) {
+			return false;
+		}
+	}
+	return true;
+}
+
 LILV_API LilvNodes*
 lilv_plugin_get_supported_features(const LilvPlugin* plugin)
 {
 	LilvNodes* optional = lilv_plugin_get_optional_features(plugin);
 	LilvNodes* required = lilv_plugin_get_required_features(plugin);
-	LilvNodes* result   = lilv_nodes_merge(optional, required);
+	LilvNodes* result   = lilv_nodes_merge_result(
+		plugin->world, optional, required);
 	lilv_nodes_free(optional);
 	lilv_nodes_free(required);
 	return result;
@@ -842,15 +1072,18 @@ LILV_API const LilvPort*
 lilv_plugin_get_port_by_symbol(const LilvPlugin* plugin,
                                const LilvNode*   symbol)
 {
-	lilv_plugin_load_ports_if_necessary(plugin);
-	for (uint32_t i = 0; i < plugin->num_ports; ++i) {
-		LilvPort* port = plugin->ports[i];
-		if (lilv_node_equals(port->symbol, symbol)) {
-			return port;
-		}
+	if (!lilv_node_is_string(symbol)) {
+		return NULL;
 	}
 
-	return NULL;
+	const LilvPortIndex* index = lilv_plugin_get_port_index(
+		plugin, &((LilvPlugin*)plugin)->ports_by_symbol, NULL);
+
+	uint32_t               n_ports = 0;
+	LilvPort* const* const ports   = lilv_port_index_find(
+		index, symbol->node, &n_ports);
+
+	return n_ports ? ports[0] : NULL;
 }
 
 LILV_API LilvNode*
@@ -962,29 +1195,44 @@ lilv_plugin_is_replaced(const LilvPlugin* plugin)
 	return plugin->replaced;
 }
 
-LILV_API LilvUIs*
-lilv_plugin_get_uis(const LilvPlugin* plugin)
+LILV_API const LilvNode*
+lilv_plugin_get_replaced_by(const LilvPlugin* plugin)
+{
+	return plugin->replaced_by;
+}
+
+/**
+   Build the UIs of `plugin` once, with types and binaries resolved.
+
+   The UIs are rebuilt only if data has been loaded into or removed from the
+   world since, since UIs are often described in separate bundles.
+*/
+static void
+lilv_plugin_load_uis_if_necessary(const LilvPlugin* plugin)
 {
 	lilv_plugin_load_if_necessary(plugin);
 
-	SordNode* ui_ui_node = sord_new_uri(plugin->world->world,
-	                                    (const uint8_t*)LV2_UI__ui);
-	SordNode* ui_binary_node = sord_new_uri(plugin->world->world,
-	                                        (const uint8_t*)LV2_UI__binary);
+	LilvPlugin* const p     = (LilvPlugin*)plugin;
+	LilvWorld* const  world = plugin->world;
+	if (plugin->uis_loaded && plugin->uis_revision == world->revision) {
+		return;
+	}
+
+	lilv_uis_free(p->uis);
 
 	LilvUIs*  result = lilv_uis_new();
-	SordIter* uis    = lilv_world_query_internal(plugin->world,
+	SordIter* uis    = lilv_world_query_internal(world,
 	                                             plugin->plugin_uri->node,
-	                                             ui_ui_node,
+	                                             world->uris.ui_ui,
 	                                             NULL);
 
 	FOREACH_MATCH(uis) {
 		const SordNode* ui = sord_iter_get_node(uis, SORD_OBJECT);
 
-		LilvNode* type   = lilv_plugin_get_unique(plugin, ui, plugin->world->uris.rdf_a);
-		LilvNode* binary = lilv_plugin_get_one(plugin, ui, plugin->world->uris.lv2_binary);
+		LilvNode* type   = lilv_plugin_get_unique(plugin, ui, world->uris.rdf_a);
+		LilvNode* binary = lilv_plugin_get_one(plugin, ui, world->uris.lv2_binary);
 		if (!binary) {
-			binary = lilv_plugin_get_unique(plugin, ui, ui_binary_node);
+			binary = lilv_plugin_get_unique(plugin, ui, world->uris.ui_binary);
 		}
 
 		if (sord_node_get_type(ui) != SORD_URI
@@ -997,32 +1245,193 @@ lilv_plugin_get_uis(const LilvPlugin* plugin)
 		}
 
 		LilvUI* lilv_ui = lilv_ui_new(
-			plugin->world,
-			lilv_node_new_from_node(plugin->world, ui),
+			world,
+			lilv_node_new_from_node(world, ui),
 			type,
 			binary);
 
-		zix_tree_insert((ZixTree*)result, lilv_ui, NULL);
+		if (lilv_array_insert((LilvArray*)result, lilv_ui)) {
+			lilv_ui_free(lilv_ui);  // Described in several graphs
+		}
 	}
 	sord_iter_free(uis);
 
-	sord_node_free(plugin->world->world, ui_binary_node);
-	sord_node_free(plugin->world->world, ui_ui_node);
-
-	if (lilv_uis_size(result) > 0) {
-		return result;
-	} else {
+	if (lilv_uis_size(result) == 0) {
 		lilv_uis_free(result);
+		result = NULL;
+	}
+
+	p->uis          = result;
+	p->uis_revision = world->revision;
+	p->uis_loaded   = true;
+}
+
+LILV_API const LilvUIs*
+lilv_plugin_get_all_uis(const LilvPlugin* plugin)
+{
+	lilv_plugin_load_uis_if_necessary(plugin);
+	return plugin->uis;
+}
+
+LILV_API LilvUIs*
+lilv_plugin_get_uis(const LilvPlugin* plugin)
+{
+	lilv_plugin_load_uis_if_necessary(plugin);
+	if (!plugin->uis) {
 		return NULL;
 	}
+
+	LilvUIs* result = lilv_uis_new();
+	LILV_FOREACH(uis, u, plugin->uis) {
+		lilv_array_insert((LilvArray*)result,
+		                  lilv_ui_duplicate(lilv_uis_get(plugin->uis, u)));
+	}
+	return result;
+}
+
+/** Set `*value` to the first value of `predicate` if it has changed. */
+static void
+lilv_plugin_refresh_value(const LilvPlugin* plugin,
+                          LilvNode**        value,
+                          const SordNode*   subject,
+                          const SordNode*   predicate)
+{
+	LilvNode* const latest = lilv_plugin_get_one(plugin, subject, predicate);
+	if (lilv_node_equals(latest, *value)) {
+		lilv_node_free(latest);
+	} else {
+		lilv_node_free(*value);
+		*value = latest;
+	}
+}
+
+/**
+   Update the presets of `plugin` if the world's data has changed.
+
+   Like UIs, presets are usually described in separate bundles and loaded on
+   demand, which changes the world's revision.  The index is updated in place,
+   so loading presets while iterating over them only adds or refreshes
+   entries, and the presets a host holds remain valid unless their data is
+   dropped from the world.
+*/
+static void
+lilv_plugin_load_presets_if_necessary(const LilvPlugin* plugin)
+{
+	lilv_plugin_load_if_necessary(plugin);
+
+	LilvPlugin* const p     = (LilvPlugin*)plugin;
+	LilvWorld* const  world = plugin->world;
+	if (plugin->presets_loaded && plugin->presets_revision == world->revision) {
+		return;
+	}
+
+	if (!p->presets) {
+		p->presets = lilv_presets_new();
+	}
+
+	lilv_nodes_free(p->blank_presets);
+	p->blank_presets = lilv_nodes_new();
+
+	size_t    n_found = 0;
+	SordIter* related = lilv_world_query_internal(world,
+	                                              NULL,
+	                                              world->uris.lv2_appliesTo,
+	                                              plugin->plugin_uri->node);
+	FOREACH_MATCH(related) {
+		const SordNode* node = sord_iter_get_node(related, SORD_SUBJECT);
+		if (!lilv_world_ask_internal(
+			    world, node, world->uris.rdf_a, world->uris.pset_Preset)) {
+			continue;
+		} else if (sord_node_get_type(node) != SORD_URI) {
+			// Not indexed by URI, but still related to the plugin
+			lilv_array_insert((LilvArray*)p->blank_presets,
+			                  lilv_node_new_from_node(world, node));
+			continue;
+		}
+
+		LilvNode*   uri    = lilv_node_new_from_node(world, node);
+		LilvPreset* preset = (LilvPreset*)lilv_presets_get_by_uri(
+			p->presets, uri);
+		if (preset) {
+			lilv_node_free(uri);
+			if (preset->revision == world->revision) {
+				continue;  // Described in several graphs
+			}
+			lilv_plugin_refresh_value(
+				plugin, &preset->label, node, world->uris.rdfs_label);
+			lilv_plugin_refresh_value(
+				plugin, &preset->bank, node, world->uris.pset_bank);
+		} else {
+			preset = lilv_preset_new(
+				world,
+				uri,
+				lilv_plugin_get_one(plugin, node, world->uris.rdfs_label),
+				lilv_plugin_get_one(plugin, node, world->uris.pset_bank));
+			zix_tree_insert((ZixTree*)p->presets, preset, NULL);
+		}
+
+		preset->revision = world->revision;
+		++n_found;
+	}
+	sord_iter_free(related);
+
+	if (n_found < lilv_collection_size(p->presets)) {
+		// Remove presets whose data has been dropped from the world
+		ZixTree*      tree  = (ZixTree*)p->presets;
+		const size_t  n_old = zix_tree_size(tree) - n_found;
+		ZixTreeIter** stale = (ZixTreeIter**)malloc(
+			n_old * sizeof(ZixTreeIter*));
+		size_t n_stale = 0;
+		for (ZixTreeIter* i = zix_tree_begin(tree);
+		     !zix_tree_iter_is_end(i);
+		     i = zix_tree_iter_next(i)) {
+			const LilvPreset* preset = (const LilvPreset*)zix_tree_get(i);
+			if (preset->revision != world->revision) {
+				stale[n_stale++] = i;
+			}
+		}
+		for (size_t i = 0; i < n_stale; ++i) {
+			zix_tree_remove(tree, stale[i]);
+		}
+		free(stale);
+	}
+
+	p->presets_revision = world->revision;
+	p->presets_loaded   = true;
+}
+
+LILV_API const LilvPresets*
+lilv_plugin_get_presets(const LilvPlugin* plugin)
+{
+	lilv_plugin_load_presets_if_necessary(plugin);
+	return lilv_collection_size(plugin->presets) ? plugin->presets : NULL;
 }
 
 LILV_API LilvNodes*
 lilv_plugin_get_related(const LilvPlugin* plugin, const LilvNode* type)
 {
+	LilvWorld* const world = plugin->world;
+	if (type && type->node == world->uris.pset_Preset) {
+		// Common case of listing presets, use the preset index
+		lilv_plugin_load_presets_if_necessary(plugin);
+
+		LilvNodes* presets = lilv_nodes_new_result(world);
+		LILV_FOREACH(presets, i, plugin->presets) {
+			const LilvPreset* preset = lilv_presets_get(plugin->presets, i);
+			lilv_nodes_add_result(
+				world, presets, lilv_node_duplicate(preset->uri));
+		}
+		LILV_FOREACH(nodes, i, plugin->blank_presets) {
+			lilv_nodes_add_result(
+				world,
+				presets,
+				lilv_node_duplicate(lilv_nodes_get(plugin->blank_presets, i)));
+		}
+		return presets;
+	}
+
 	lilv_plugin_load_if_necessary(plugin);
 
-	LilvWorld* const world   = plugin->world;
 	LilvNodes* const related = lilv_world_find_nodes_internal(
 		world,
 		NULL,
@@ -1033,14 +1442,12 @@ lilv_plugin_get_related(const LilvPlugin* plugin, const LilvNode* type)
 		return related;
 	}
 
-	LilvNodes* matches = lilv_nodes_new();
+	LilvNodes* matches = lilv_nodes_new_result(world);
 	LILV_FOREACH(nodes, i, related) {
-		LilvNode* node  = (LilvNode*)lilv_collection_get((ZixTree*)related, i);
+		const LilvNode* node = lilv_nodes_get(related, i);
 		if (lilv_world_ask_internal(
 			    world, node->node, world->uris.rdf_a, type->node)) {
-			zix_tree_insert((ZixTree*)matches,
-			                lilv_node_new_from_node(world, node->node),
-			                NULL);
+			lilv_nodes_add_result(world, matches, lilv_node_duplicate(node));
 		}
 	}
 
@@ -36,9 +36,26 @@ lilv_plugin_class_new(LilvWorld*      world,
 	pc->parent_uri = (parent_node
 	                  ? lilv_node_new_from_node(world, parent_node)
 	                  : NULL);
+	pc->parent     = NULL;
+	pc->children   = NULL;
+	pc->n_children = 0;
+	pc->ancestors  = NULL;
+	pc->depth      = 0;
 	return pc;
 }
 
+void
+lilv_plugin_class_clear_tree(LilvPluginClass* plugin_class)
+{
+	free(plugin_class->children);
+	free(plugin_class->ancestors);
+	plugin_class->parent     = NULL;
+	plugin_class->children   = NULL;
+	plugin_class->n_children = 0;
+	plugin_class->ancestors  = NULL;
+	plugin_class->depth      = 0;
+}
+
 void
 lilv_plugin_class_free(LilvPluginClass* plugin_class)
 {
@@ -49,6 +66,7 @@ lilv_plugin_class_free(LilvPluginClass* plugin_class)
 	lilv_node_free(plugin_class->uri);
 	lilv_node_free(plugin_class->parent_uri);
 	lilv_node_free(plugin_class->label);
+	lilv_plugin_class_clear_tree(plugin_class);
 	free(plugin_class);
 }
 
@@ -70,22 +88,61 @@ lilv_plugin_class_get_label(const LilvPluginClass* plugin_class)
 	return plugin_class->label;
 }
 
+LILV_API const LilvPluginClass*
+lilv_plugin_class_get_parent(const LilvPluginClass* plugin_class)
+{
+	lilv_world_load_classes_if_necessary(plugin_class->world);
+	return plugin_class->parent;
+}
+
+LILV_API unsigned
+lilv_plugin_class_get_depth(const LilvPluginClass* plugin_class)
+{
+	lilv_world_load_classes_if_necessary(plugin_class->world);
+	return plugin_class->depth;
+}
+
+LILV_API unsigned
+lilv_plugin_class_get_num_children(const LilvPluginClass* plugin_class)
+{
+	lilv_world_load_classes_if_necessary(plugin_class->world);
+	return plugin_class->n_children;
+}
+
+LILV_API const LilvPluginClass*
+lilv_plugin_class_get_child(const LilvPluginClass* plugin_class,
+                            unsigned               index)
+{
+	lilv_world_load_classes_if_necessary(plugin_class->world);
+	return (index < plugin_class->n_children
+	        ? plugin_class->children[index]
+	        : NULL);
+}
+
+LILV_API bool
+lilv_plugin_class_is_descendant_of(const LilvPluginClass* plugin_class,
+                                   const LilvPluginClass* ancestor)
+{
+	lilv_world_load_classes_if_necessary(plugin_class->world);
+
+	/* Compare URIs since the loaded lv2:Plugin class is an alias of the root,
+	   and URI nodes are interned so this is a pointer comparison. */
+	return (ancestor->depth < plugin_class->depth &&
+	        plugin_class->ancestors[ancestor->depth]->uri->node ==
+	        ancestor->uri->node);
+}
+
 LILV_API LilvPluginClasses*
 lilv_plugin_class_get_children(const LilvPluginClass* plugin_class)
 {
+	lilv_world_load_classes_if_necessary(plugin_class->world);
+
 	// Returned list doesn't own categories
-	LilvPluginClasses* all    = plugin_class->world->plugin_classes;
 	LilvPluginClasses* result = zix_tree_new(false, lilv_ptr_cmp, NULL, NULL);
-
-	for (ZixTreeIter* i = zix_tree_begin((ZixTree*)all);
-	     i != zix_tree_end((ZixTree*)all);
-	     i = zix_tree_iter_next(i)) {
-		const LilvPluginClass* c      = (LilvPluginClass*)zix_tree_get(i);
-		const LilvNode*        parent = lilv_plugin_class_get_parent_uri(c);
-		if (parent && lilv_node_equals(lilv_plugin_class_get_uri(plugin_class),
-		                               parent)) {
-			zix_tree_insert((ZixTree*)result, (LilvPluginClass*)c, NULL);
-		}
+	for (unsigned i = 0; i < plugin_class->n_children; ++i) {
+		zix_tree_insert((ZixTree*)result,
+		                (LilvPluginClass*)plugin_class->children[i],
+		                NULL);
 	}
 
 	return result;
@@ -228,15 +228,16 @@ LILV_API LilvScalePoints*
 lilv_port_get_scale_points(const LilvPlugin* plugin,
                            const LilvPort*   port)
 {
-	SordIter* points = lilv_world_query_internal(
-		plugin->world,
+	LilvWorld* world  = plugin->world;
+	SordIter*  points = lilv_world_query_internal(
+		world,
 		port->node->node,
-		sord_new_uri(plugin->world->world, (const uint8_t*)LV2_CORE__scalePoint),
+		sord_new_uri(world->world, (const uint8_t*)LV2_CORE__scalePoint),
 		NULL);
 
 	LilvScalePoints* ret = NULL;
 	if (!sord_iter_end(points)) {
-		ret = lilv_scale_points_new();
+		ret = lilv_scale_points_new_result(world);
 	}
 
 	FOREACH_MATCH(points) {
@@ -244,15 +245,24 @@ lilv_port_get_scale_points(const LilvPlugin* plugin,
 
 		LilvNode* value = lilv_plugin_get_unique(plugin,
 		                                         point,
-		                                         plugin->world->uris.rdf_value);
+		                                         world->uris.rdf_value);
 
 		LilvNode* label = lilv_plugin_get_unique(plugin,
 		                                         point,
-		                                         plugin->world->uris.rdfs_label);
-
-		if (value && label) {
-			zix_tree_insert(
-				(ZixTree*)ret, lilv_scale_point_new(value, label), NULL);
+		                                         world->uris.rdfs_label);
+
+		if (value && label && world->arena) {
+			// The arena holds the references until it is reset
+			value = lilv_arena_hold(world->arena, value);
+			label = lilv_arena_hold(world->arena, label);
+			if (value && label) {
+				lilv_array_insert(
+					(LilvArray*)ret,
+					lilv_scale_point_new_in(world->arena, value, label));
+			}
+		} else if (value && label) {
+			lilv_array_insert(
+				(LilvArray*)ret, lilv_scale_point_new(value, label));
 		}
 	}
 	sord_iter_free(points);
@@ -0,0 +1,337 @@
+/*
+  Copyright 2007-2019 David Robillard <http://drobilla.net>
+
+  Permission to use, copy, modify, and/or distribute this software for any
+  purpose with or without fee is hereby granted, provided that the above
+  copyright notice and this permission notice appear in all copies.
+
+  THIS SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+  WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+  MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+  ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+  WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+  ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+  OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+
+#include "lilv_internal.h"
+
+#include "lilv/lilv.h"
+#include "sord/sord.h"
+
+#include <math.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+/** A flag that is set if a port has some resource as a value. */
+typedef struct {
+	const SordNode* node;
+	uint32_t        flag;
+} LilvPortFlagMapping;
+
+static uint32_t
+lilv_port_flag(const LilvPortFlagMapping* mappings, const SordNode* node)
+{
+	for (const LilvPortFlagMapping* m = mappings; m->node; ++m) {
+		if (sord_node_equals(m->node, node)) {
+			return m->flag;
+		}
+	}
+	return 0;
+}
+
+/** Return `node` as a float, like lilv_node_as_float(). */
+static float
+lilv_port_table_float(LilvWorld* world, const SordNode* node)
+{
+	LilvNode* const value  = lilv_node_new_from_node(world, node);
+	const float     result = lilv_node_as_float(value);
+	lilv_node_free(value);
+	return result;
+}
+
+LilvPortTable*
+lilv_port_table_new(const LilvPlugin* plugin)
+{
+	LilvWorld* const world = plugin->world;
+	const uint32_t   n     = plugin->num_ports;
+
+	const LilvPortFlagMapping types[] = {
+		{ world->uris.lv2_InputPort,   LILV_PORT_INPUT },
+		{ world->uris.lv2_OutputPort,  LILV_PORT_OUTPUT },
+		{ world->uris.lv2_AudioPort,   LILV_PORT_AUDIO },
+		{ world->uris.lv2_ControlPort, LILV_PORT_CONTROL },
+		{ world->uris.lv2_CVPort,      LILV_PORT_CV },
+		{ world->uris.atom_AtomPort,   LILV_PORT_ATOM },
+		{ world->uris.ev_EventPort,    LILV_PORT_EVENT },
+		{ NULL, 0 } };
+
+	const LilvPortFlagMapping properties[] = {
+		{ world->uris.lv2_connectionOptional, LILV_PORT_CONNECTION_OPTIONAL },
+		{ world->uris.lv2_enumeration,        LILV_PORT_ENUMERATION },
+		{ world->uris.lv2_integer,            LILV_PORT_INTEGER },
+		{ world->uris.lv2_isSideChain,        LILV_PORT_IS_SIDE_CHAIN },
+		{ world->uris.lv2_reportsLatency,     LILV_PORT_REPORTS_LATENCY },
+		{ world->uris.lv2_sampleRate,         LILV_PORT_SAMPLE_RATE },
+		{ world->uris.lv2_toggled,            LILV_PORT_TOGGLED },
+		{ world->uris.pprops_causesArtifacts, LILV_PORT_CAUSES_ARTIFACTS },
+		{ world->uris.pprops_expensive,       LILV_PORT_EXPENSIVE },
+		{ world->uris.pprops_logarithmic,     LILV_PORT_LOGARITHMIC },
+		{ world->uris.pprops_notOnGUI,        LILV_PORT_NOT_ON_GUI },
+		{ world->uris.pprops_trigger,         LILV_PORT_TRIGGER },
+		{ NULL, 0 } };
+
+	LilvPortTable* table = (LilvPortTable*)malloc(sizeof(LilvPortTable));
+	table->n_ports      = n;
+	table->symbols      = (const LilvNode**)calloc(n, sizeof(LilvNode*));
+	table->flags        = (uint32_t*)calloc(n, sizeof(uint32_t));
+	table->properties   = (uint32_t*)calloc(n, sizeof(uint32_t));
+	table->minimums     = (float*)calloc(n, sizeof(float));
+	table->maximums     = (float*)calloc(n, sizeof(float));
+	table->defaults     = (float*)calloc(n, sizeof(float));
+	table->designations = (LilvNode**)calloc(n, sizeof(LilvNode*));
+
+	for (uint32_t i = 0; i < n; ++i) {
+		const LilvPort* port = plugin->ports[i];
+
+		table->symbols[i]  = port->symbol;
+		table->minimums[i] = NAN;
+		table->maximums[i] = NAN;
+		table->defaults[i] = NAN;
+
+		bool has_minimum = false;
+		bool has_maximum = false;
+		bool has_default = false;
+
+		// Read everything from a single scan over all statements about the port
+		SordIter* s = lilv_world_query_internal(
+			world, port->node->node, NULL, NULL);
+		FOREACH_MATCH(s) {
+			const SordNode* pred = sord_iter_get_node(s, SORD_PREDICATE);
+			const SordNode* obj  = sord_iter_get_node(s, SORD_OBJECT);
+			if (sord_node_equals(pred, world->uris.rdf_a)) {
+				table->flags[i] |= lilv_port_flag(types, obj);
+			} else if (sord_node_equals(pred, world->uris.lv2_portProperty)) {
+				table->properties[i] |= lilv_port_flag(properties, obj);
+			} else if (sord_node_equals(pred, world->uris.lv2_minimum)) {
+				if (!has_minimum) {
+					table->minimums[i] = lilv_port_table_float(world, obj);
+					has_minimum       = true;
+				}
+			} else if (sord_node_equals(pred, world->uris.lv2_maximum)) {
+				if (!has_maximum) {
+					table->maximums[i] = lilv_port_table_float(world, obj);
+					has_maximum       = true;
+				}
+			} else if (sord_node_equals(pred, world->uris.lv2_default)) {
+				if (!has_default) {
+					table->defaults[i] = lilv_port_table_float(world, obj);
+					has_default       = true;
+				}
+			} else if (sord_node_equals(pred, world->uris.lv2_designation)) {
+				if (!table->designations[i] &&
+				    sord_node_get_type(obj) == SORD_URI) {
+					table->designations[i] = lilv_node_new_from_node(world, obj);
+				}
+			}
+		}
+		sord_iter_free(s);
+	}
+
+	return table;
+}
+
+void
+lilv_port_table_free(LilvPortTable* table)
+{
+	if (table) {
+		for (uint32_t i = 0; i < table->n_ports; ++i) {
+			lilv_node_free(table->designations[i]);
+		}
+		free(table->designations);
+		free(table->defaults);
+		free(table->maximums);
+		free(table->minimums);
+		free(table->properties);
+		free(table->flags);
+		free(table->symbols);
+		free(table);
+	}
+}
+
+/** A run of ports in a port index which share a value. */
+typedef struct {
+	const SordNode* value;  ///< Interned node, so compared by address
+	uint32_t        first;  ///< Index of first port in LilvPortIndex::ports
+	uint32_t        count;  ///< Number of ports with this value
+} LilvPortGroup;
+
+struct LilvPortIndexImpl {
+	ZixHash*   groups;  ///< Set of LilvPortGroup, keyed by value
+	LilvPort** ports;   ///< Indexed ports, grouped by value
+};
+
+static uint32_t
+lilv_port_group_hash(const void* value)
+{
+	return lilv_ptr_hash(((const LilvPortGroup*)value)->value);
+}
+
+static bool
+lilv_port_group_equals(const void* a, const void* b)
+{
+	return ((const LilvPortGroup*)a)->value == ((const LilvPortGroup*)b)->value;
+}
+
+static int
+lilv_port_group_cmp(const void* a, const void* b)
+{
+	const LilvPortGroup* ga = (const LilvPortGroup*)a;
+	const LilvPortGroup* gb = (const LilvPortGroup*)b;
+	if (ga->value != gb->value) {
+		return (uintptr_t)ga->value < (uintptr_t)gb->value ? -1 : 1;
+	}
+	return ga->first < gb->first ? -1 : ga->first > gb->first ? 1 : 0;
+}
+
+/**
+   Create an index of the ports of `plugin` by the objects of `predicate`.
+
+   If `predicate` is NULL, ports are indexed by symbol.  Ports which share a
+   value are stored in port index order, so the first match of a lookup is the
+   same port a linear search would have found.
+*/
+LilvPortIndex*
+lilv_port_index_new(const LilvPlugin* plugin, const SordNode* predicate)
+{
+	LilvWorld* const world = plugin->world;
+	const uint32_t   n     = plugin->num_ports;
+
+	// Collect (value, port index) pairs, using count as the port index
+	uint32_t       n_pairs   = 0;
+	uint32_t       max_pairs = n;
+	LilvPortGroup* pairs     = (LilvPortGroup*)calloc(
+		max_pairs ? max_pairs : 1, sizeof(LilvPortGroup));
+
+	for (uint32_t i = 0; i < n; ++i) {
+		const LilvPort* port = plugin->ports[i];
+		if (!predicate) {
+			const LilvPortGroup pair = { port->symbol->node, i, 1 };
+			pairs[n_pairs++]         = pair;
+			continue;
+		}
+
+		SordIter* s = lilv_world_query_internal(
+			world, port->node->node, predicate, NULL);
+		FOREACH_MATCH(s) {
+			if (n_pairs == max_pairs) {
+				max_pairs *= 2;
+				pairs = (LilvPortGroup*)realloc(
+					pairs, max_pairs * sizeof(LilvPortGroup));
+			}
+			const LilvPortGroup pair = {
+				sord_iter_get_node(s, SORD_OBJECT), i, 1 };
+			pairs[n_pairs++] = pair;
+		}
+		sord_iter_free(s);
+	}
+
+	qsort(pairs, n_pairs, sizeof(LilvPortGroup), lilv_port_group_cmp);
+
+	LilvPortIndex* index = (LilvPortIndex*)malloc(sizeof(LilvPortIndex));
+	index->groups = zix_hash_new(
+		lilv_port_group_hash, lilv_port_group_equals, sizeof(LilvPortGroup));
+	index->ports = (LilvPort**)calloc(n_pairs ? n_pairs : 1, sizeof(LilvPort*));
+
+	// Store ports in sorted order and make a group for every run of values
+	LilvPortGroup* group = NULL;
+	for (uint32_t i = 0; i < n_pairs; ++i) {
+		index->ports[i] = plugin->ports[pairs[i].first];
+		if (group && group->value == pairs[i].value) {
+			++group->count;
+		} else {
+			const LilvPortGroup g = { pairs[i].value, i, 1 };
+			zix_hash_insert(index->groups, &g, (void**)&group);
+		}
+	}
+
+	free(pairs);
+	return index;
+}
+
+void
+lilv_port_index_free(LilvPortIndex* index)
+{
+	if (index) {
+		zix_hash_free(index->groups);
+		free(index->ports);
+		free(index);
+	}
+}
+
+/**
+   Return the ports in `index` with `value`, in port index order.
+
+   This does not allocate, and only does a single hash lookup.
+*/
+LilvPort* const*
+lilv_port_index_find(const LilvPortIndex* index,
+                     const SordNode*      value,
+                     uint32_t*            n_ports)
+{
+	const LilvPortGroup  key   = { value, 0, 0 };
+	const LilvPortGroup* group = (const LilvPortGroup*)zix_hash_find(
+		index->groups, &key);
+
+	*n_ports = group ? group->count : 0;
+	return group ? index->ports + group->first : NULL;
+}
+
+LILV_API uint32_t
+lilv_port_table_get_num_ports(const LilvPortTable* table)
+{
+	return table->n_ports;
+}
+
+LILV_API const LilvNode* const*
+lilv_port_table_get_symbols(const LilvPortTable* table)
+{
+	return table->symbols;
+}
+
+LILV_API const uint32_t*
+lilv_port_table_get_flags(const LilvPortTable* table)
+{
+	return table->flags;
+}
+
+LILV_API const uint32_t*
+lilv_port_table_get_properties(const LilvPortTable* table)
+{
+	return table->properties;
+}
+
+LILV_API const float*
+lilv_port_table_get_minimums(const LilvPortTable* table)
+{
+	return table->minimums;
+}
+
+LILV_API const float*
+lilv_port_table_get_maximums(const LilvPortTable* table)
+{
+	return table->maximums;
+}
+
+LILV_API const float*
+lilv_port_table_get_defaults(const LilvPortTable* table)
+{
+	return table->defaults;
+}
+
+LILV_API const LilvNode* const*
+lilv_port_table_get_designations(const LilvPortTable* table)
+{
+	return (const LilvNode* const*)table->designations;
+}
@@ -0,0 +1,66 @@
+/*
+  Copyright 2007-2019 David Robillard <http://drobilla.net>
+
+  Permission to use, copy, modify, and/or distribute this software for any
+  purpose with or without fee is hereby granted, provided that the above
+  copyright notice and this permission notice appear in all copies.
+
+  THIS SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+  WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+  MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+  ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+  WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+  ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+  OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+
+#include "lilv_internal.h"
+
+#include "lilv/lilv.h"
+
+#include <stdlib.h>
+
+/** Ownership of uri, label, and bank is taken */
+LilvPreset*
+lilv_preset_new(LilvWorld* world,
+                LilvNode*  uri,
+                LilvNode*  label,
+                LilvNode*  bank)
+{
+	LilvPreset* preset = (LilvPreset*)malloc(sizeof(LilvPreset));
+	preset->world    = world;
+	preset->uri      = uri;
+	preset->label    = label;
+	preset->bank     = bank;
+	preset->revision = 0;
+	return preset;
+}
+
+void
+lilv_preset_free(LilvPreset* preset)
+{
+	if (preset) {
+		lilv_node_free(preset->uri);
+		lilv_node_free(preset->label);
+		lilv_node_free(preset->bank);
+		free(preset);
+	}
+}
+
+LILV_API const LilvNode*
+lilv_preset_get_uri(const LilvPreset* preset)
+{
+	return preset->uri;
+}
+
+LILV_API const LilvNode*
+lilv_preset_get_label(const LilvPreset* preset)
+{
+	return preset->label;
+}
+
+LILV_API const LilvNode*
+lilv_preset_get_bank(const LilvPreset* preset)
+{
+	return preset->bank;
+}
@@ -20,6 +20,7 @@
 #include "sord/sord.h"
 #include "zix/tree.h"
 
+#include <stdbool.h>
 #include <stdlib.h>
 #include <string.h>
 
@@ -48,73 +49,158 @@ lilv_lang_matches(const char* a, const char* b)
 	return LILV_LANG_MATCH_NONE;
 }
 
-static LilvNodes*
-lilv_nodes_from_stream_objects_i18n(LilvWorld*    world,
-                                    SordIter*     stream,
-                                    SordQuadIndex field)
+struct LilvQueryImpl {
+	LilvWorld*      world;
+	SordIter*       stream;
+	SordQuadIndex   field;
+	const char*     syslang;  ///< System language, if filtering by language
+	const SordNode* nolang;   ///< Untranslated value
+	const SordNode* partial;  ///< Partial language match
+	LilvNode*       value;    ///< Current match (owned), or NULL at end
+	bool            matched;  ///< True iff a value in the stream matched
+};
+
+/** Return true iff `node` passes the language filter of `query`. */
+static bool
+lilv_query_accepts(LilvQuery* query, const SordNode* node)
 {
-	LilvNodes*      values  = lilv_nodes_new();
-	const SordNode* nolang  = NULL;  // Untranslated value
-	const SordNode* partial = NULL;  // Partial language match
-	char*           syslang = lilv_get_lang();
-	FOREACH_MATCH(stream) {
-		const SordNode* value = sord_iter_get_node(stream, field);
-		if (sord_node_get_type(value) == SORD_LITERAL) {
-			const char*   lang = sord_node_get_language(value);
-			LilvLangMatch lm   = LILV_LANG_MATCH_NONE;
-			if (lang) {
-				lm = (syslang)
-					? lilv_lang_matches(lang, syslang)
-					: LILV_LANG_MATCH_PARTIAL;
-			} else {
-				nolang = value;
-				if (!syslang) {
-					lm = LILV_LANG_MATCH_EXACT;
-				}
-			}
-
-			if (lm == LILV_LANG_MATCH_EXACT) {
-				// Exact language match, add to results
-				zix_tree_insert((ZixTree*)values,
-				                lilv_node_new_from_node(world, value),
-				                NULL);
-			} else if (lm == LILV_LANG_MATCH_PARTIAL) {
-				// Partial language match, save in case we find no exact
-				partial = value;
-			}
-		} else {
-			zix_tree_insert((ZixTree*)values,
-			                lilv_node_new_from_node(world, value),
-			                NULL);
+	if (!query->world->opt.filter_language ||
+	    sord_node_get_type(node) != SORD_LITERAL) {
+		return true;
+	}
+
+	const char*   lang = sord_node_get_language(node);
+	LilvLangMatch lm   = LILV_LANG_MATCH_NONE;
+	if (lang) {
+		lm = (query->syslang)
+			? lilv_lang_matches(lang, query->syslang)
+			: LILV_LANG_MATCH_PARTIAL;
+	} else {
+		query->nolang = node;
+		if (!query->syslang) {
+			lm = LILV_LANG_MATCH_EXACT;
 		}
 	}
-	sord_iter_free(stream);
-	free(syslang);
 
-	if (lilv_nodes_size(values) > 0) {
-		return values;
+	if (lm == LILV_LANG_MATCH_PARTIAL) {
+		// Partial language match, save in case we find no exact
+		query->partial = node;
 	}
 
-	const SordNode* best = nolang;
-	if (syslang && partial) {
+	return lm == LILV_LANG_MATCH_EXACT;
+}
+
+/** Move `query` to the first match at or after the current stream position. */
+static void
+lilv_query_seek(LilvQuery* query)
+{
+	FOREACH_MATCH(query->stream) {
+		const SordNode* node = sord_iter_get_node(query->stream, query->field);
+		if (lilv_query_accepts(query, node) &&
+		    (query->value = lilv_node_new_from_node(query->world, node))) {
+			query->matched = true;
+			return;
+		}
+	}
+
+	query->value = NULL;
+	if (query->matched) {
+		return;
+	}
+
+	// No exact matches, fall back to the best translation, if any
+	const SordNode* best = query->nolang;
+	if (query->syslang && query->partial) {
 		// Partial language match for system language
-		best = partial;
+		best = query->partial;
 	} else if (!best) {
 		// No languages matches at all, and no untranslated value
 		// Use any value, if possible
-		best = partial;
+		best = query->partial;
 	}
 
+	query->matched = true;
 	if (best) {
-		zix_tree_insert(
-			(ZixTree*)values, lilv_node_new_from_node(world, best), NULL);
-	} else {
-		// No matches whatsoever
-		lilv_nodes_free(values);
-		values = NULL;
+		query->value = lilv_node_new_from_node(query->world, best);
 	}
+}
 
-	return values;
+static void
+lilv_query_init(LilvQuery*    query,
+                LilvWorld*    world,
+                SordIter*     stream,
+                SordQuadIndex field)
+{
+	query->world   = world;
+	query->stream  = stream;
+	query->field   = field;
+	query->syslang = (world->opt.filter_language
+	                  ? lilv_world_get_lang(world)
+	                  : NULL);
+	query->nolang  = NULL;
+	query->partial = NULL;
+	query->value   = NULL;
+	query->matched = false;
+	lilv_query_seek(query);
+}
+
+static void
+lilv_query_finish(LilvQuery* query)
+{
+	lilv_node_free(query->value);
+	sord_iter_free(query->stream);
+}
+
+LilvQuery*
+lilv_query_new(LilvWorld* world, SordIter* stream, SordQuadIndex field)
+{
+	LilvQuery* query = (LilvQuery*)malloc(sizeof(LilvQuery));
+	if (!query) {
+		sord_iter_free(stream);
+		return NULL;
+	}
+
+	lilv_query_init(query, world, stream, field);
+	return query;
+}
+
+LILV_API bool
+lilv_query_is_end(const LilvQuery* query)
+{
+	return !query || !query->value;
+}
+
+LILV_API const LilvNode*
+lilv_query_get(const LilvQuery* query)
+{
+	return query ? query->value : NULL;
+}
+
+LILV_API bool
+lilv_query_next(LilvQuery* query)
+{
+	if (lilv_query_is_end(query)) {
+		return true;
+	}
+
+	lilv_node_free(query->value);
+	query->value = NULL;
+	if (sord_iter_end(query->stream)) {
+		return true;  // Fallback value was the last match
+	}
+
+	sord_iter_next(query->stream);
+	lilv_query_seek(query);
+	return lilv_query_is_end(query);
+}
+
+LILV_API void
+lilv_query_free(LilvQuery* query)
+{
+	if (query) {
+		lilv_query_finish(query);
+		free(query);
+	}
 }
 
 LilvNodes*
@@ -122,21 +208,18 @@ lilv_nodes_from_stream_objects(LilvWorld*    world,
                                SordIter*     stream,
                                SordQuadIndex field)
 {
-	if (sord_iter_end(stream)) {
-		sord_iter_free(stream);
+	LilvQuery query;
+	lilv_query_init(&query, world, stream, field);
+	if (lilv_query_is_end(&query)) {
+		lilv_query_finish(&query);
 		return NULL;
-	} else if (world->opt.filter_language) {
-		return lilv_nodes_from_stream_objects_i18n(world, stream, field);
-	} else {
-		LilvNodes* values = lilv_nodes_new();
-		FOREACH_MATCH(stream) {
-			const SordNode* value = sord_iter_get_node(stream, field);
-			LilvNode*       node  = lilv_node_new_from_node(world, value);
-			if (node) {
-				zix_tree_insert((ZixTree*)values, node, NULL);
-			}
-		}
-		sord_iter_free(stream);
-		return values;
 	}
+
+	LilvNodes* values = lilv_nodes_new_result(world);
+	for (; !lilv_query_is_end(&query); lilv_query_next(&query)) {
+		lilv_nodes_add_result(world, values, lilv_node_duplicate(query.value));
+	}
+
+	lilv_query_finish(&query);
+	return values;
 }
@@ -30,6 +30,21 @@ lilv_scale_point_new(LilvNode* value, LilvNode* label)
 	return point;
 }
 
+/** Create a scale point in `arena`, which holds value and label */
+LilvScalePoint*
+lilv_scale_point_new_in(LilvArena*      arena,
+                        const LilvNode* value,
+                        const LilvNode* label)
+{
+	LilvScalePoint* point = (LilvScalePoint*)lilv_arena_alloc(
+		arena, sizeof(LilvScalePoint));
+	if (point) {
+		point->value = (LilvNode*)value;
+		point->label = (LilvNode*)label;
+	}
+	return point;
+}
+
 void
 lilv_scale_point_free(LilvScalePoint* point)
 {
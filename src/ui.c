@@ -47,11 +47,27 @@ lilv_ui_new(LilvWorld* world,
 	free(bundle);
 
 	ui->classes = lilv_nodes_new();
-	zix_tree_insert((ZixTree*)ui->classes, type_uri, NULL);
+	lilv_array_insert((LilvArray*)ui->classes, type_uri);
 
 	return ui;
 }
 
+LilvUI*
+lilv_ui_duplicate(const LilvUI* ui)
+{
+	LilvUI* copy = (LilvUI*)malloc(sizeof(LilvUI));
+	copy->world      = ui->world;
+	copy->uri        = lilv_node_duplicate(ui->uri);
+	copy->bundle_uri = lilv_node_duplicate(ui->bundle_uri);
+	copy->binary_uri = lilv_node_duplicate(ui->binary_uri);
+	copy->classes    = lilv_nodes_new();
+	LILV_FOREACH(nodes, c, ui->classes) {
+		lilv_array_insert((LilvArray*)copy->classes,
+		                  lilv_node_duplicate(lilv_nodes_get(ui->classes, c)));
+	}
+	return copy;
+}
+
 void
 lilv_ui_free(LilvUI* ui)
 {
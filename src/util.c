@@ -54,6 +54,7 @@ CreateSymbolicLink(LPCTSTR linkpath, LPCTSTR targetpath, DWORD flags)
 #    endif
 #else
 #    include <dirent.h>
+#    include <sys/time.h>
 #    include <unistd.h>
 #endif
 
@@ -61,6 +62,11 @@ CreateSymbolicLink(LPCTSTR linkpath, LPCTSTR targetpath, DWORD flags)
 #    include <sys/file.h>
 #endif
 
+#ifdef HAVE_MMAP
+#    include <fcntl.h>
+#    include <sys/mman.h>
+#endif
+
 #include <sys/stat.h>
 #include <sys/types.h>
 
@@ -73,6 +79,7 @@ CreateSymbolicLink(LPCTSTR linkpath, LPCTSTR targetpath, DWORD flags)
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <time.h>
 
 #ifndef PAGE_SIZE
 #    define PAGE_SIZE 4096
@@ -131,6 +138,19 @@ lilv_strdup(const char* str)
 	return copy;
 }
 
+/** Set `bit` in a bitset of `*n_words` words, growing it if necessary. */
+void
+lilv_bitset_set(uint32_t** bits, uint32_t* n_words, uint32_t bit)
+{
+	const uint32_t word = bit / 32;
+	if (word >= *n_words) {
+		*bits = (uint32_t*)realloc(*bits, (word + 1) * sizeof(uint32_t));
+		memset(*bits + *n_words, 0, (word + 1 - *n_words) * sizeof(uint32_t));
+		*n_words = word + 1;
+	}
+	(*bits)[word] |= 1u << (bit % 32);
+}
+
 const char*
 lilv_uri_to_path(const char* uri)
 {
@@ -292,6 +312,99 @@ lilv_path_exists(const char* path, const void* ignored)
 #endif
 }
 
+#ifdef HAVE_MMAP
+
+/** Size of chunks handed to the reader from a mapped file. */
+#define LILV_MAPPED_PAGE_SIZE 4096
+
+/** A file mapped into memory, read as a serd source. */
+typedef struct {
+	const uint8_t* buf;     ///< Start of mapping
+	size_t         size;    ///< Size of mapping
+	size_t         offset;  ///< Read offset
+} LilvMappedFile;
+
+static size_t
+lilv_mapped_file_read(void* buf, size_t size, size_t nmemb, void* stream)
+{
+	LilvMappedFile* const file = (LilvMappedFile*)stream;
+	size_t                n    = size * nmemb;
+	if (n > file->size - file->offset) {
+		n = file->size - file->offset;
+	}
+
+	memcpy(buf, file->buf + file->offset, n);
+	file->offset += n;
+	return n / size;
+}
+
+static int
+lilv_mapped_file_error(void* stream)
+{
+	return 0;
+}
+
+#endif  // HAVE_MMAP
+
+/**
+   Read the Turtle file at `uri`.
+
+   Local files are mapped into memory if possible, which saves the system
+   calls of buffered reads.  The mapping is read as a source named by the
+   file path, exactly like serd_reader_read_file() reads the file, so errors
+   and the handling of unusual content like NUL bytes are the same.
+
+   A mapped file must not be truncated while it is being read, since
+   accessing the mapping past the new end of the file raises SIGBUS.  LV2
+   data is installed and not edited in place, but configuring with --no-mmap
+   avoids this if it matters.
+*/
+SerdStatus
+lilv_reader_read_file(SerdReader* reader, const uint8_t* uri)
+{
+#ifdef HAVE_MMAP
+	char* const path = lilv_file_uri_parse((const char*)uri, NULL);
+	const int   fd   = path ? open(path, O_RDONLY) : -1;
+	struct stat st;
+	if (fd >= 0 && !fstat(fd, &st) && st.st_size > 0) {
+		const size_t size = (size_t)st.st_size;
+		void* const  map  = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+		if (map != MAP_FAILED) {
+			close(fd);
+			madvise(map, size, MADV_SEQUENTIAL);
+
+			LilvMappedFile   file   = { (const uint8_t*)map, size, 0 };
+			const SerdStatus status = serd_reader_read_source(
+				reader,
+				lilv_mapped_file_read,
+				lilv_mapped_file_error,
+				&file,
+				(const uint8_t*)path,
+				LILV_MAPPED_PAGE_SIZE);
+
+			munmap(map, size);
+			lilv_free(path);
+			return status;
+		}
+	}
+
+	// Not a local file that can be mapped, read it normally
+	if (fd >= 0) {
+		close(fd);
+	}
+	lilv_free(path);
+#endif
+
+	return serd_reader_read_file(reader, uri);
+}
+
+bool
+lilv_is_directory(const char* path)
+{
+	struct stat st;
+	return !stat(path, &st) && (st.st_mode & S_IFMT) == S_IFDIR;
+}
+
 char*
 lilv_find_free_path(const char* in_path,
                     bool (*exists)(const char*, const void*),
@@ -617,6 +730,165 @@ lilv_file_size(const char* path)
 	return buf.st_size;
 }
 
+/** Return the modification time of a file in nanoseconds. */
+static int64_t
+lilv_stat_mtime(const struct stat* st)
+{
+#if defined(__APPLE__)
+	return ((int64_t)st->st_mtimespec.tv_sec * 1000000000 +
+	        st->st_mtimespec.tv_nsec);
+#elif defined(_WIN32)
+	return (int64_t)st->st_mtime * 1000000000;
+#else
+	return (int64_t)st->st_mtim.tv_sec * 1000000000 + st->st_mtim.tv_nsec;
+#endif
+}
+
+/** Return the status change time of a file in nanoseconds. */
+static int64_t
+lilv_stat_ctime(const struct stat* st)
+{
+#if defined(__APPLE__)
+	return ((int64_t)st->st_ctimespec.tv_sec * 1000000000 +
+	        st->st_ctimespec.tv_nsec);
+#elif defined(_WIN32)
+	return (int64_t)st->st_ctime * 1000000000;
+#else
+	return (int64_t)st->st_ctim.tv_sec * 1000000000 + st->st_ctim.tv_nsec;
+#endif
+}
+
+/** Update the newest data times in `stamp` to include `st`. */
+static void
+lilv_bundle_stamp_update(LilvBundleStamp* stamp, const struct stat* st)
+{
+	const int64_t mtime = lilv_stat_mtime(st);
+	const int64_t ctime = lilv_stat_ctime(st);
+	if (mtime > stamp->data_mtime) {
+		stamp->data_mtime = mtime;
+	}
+	if (ctime > stamp->data_ctime) {
+		stamp->data_ctime = ctime;
+	}
+}
+
+/** Add the times of a file, and everything under it, to a LilvBundleStamp. */
+static void
+lilv_bundle_stamp_file(const char* dir_path, const char* name, void* data)
+{
+	if (!strcmp(name, ".") || !strcmp(name, "..")) {
+		return;
+	}
+
+	LilvBundleStamp* const stamp = (LilvBundleStamp*)data;
+	char* const            path  = lilv_path_join(dir_path, name);
+	struct stat            st;
+#ifdef HAVE_LSTAT
+	if (!lstat(path, &st)) {
+#else
+	if (!stat(path, &st)) {
+#endif
+		lilv_bundle_stamp_update(stamp, &st);
+		if ((st.st_mode & S_IFMT) == S_IFDIR) {
+			lilv_dir_for_each(path, stamp, lilv_bundle_stamp_file);
+		} else if ((st.st_mode & S_IFMT) != S_IFREG && !stat(path, &st)) {
+			// Include the target of a link, but never descend into it
+			lilv_bundle_stamp_update(stamp, &st);
+		}
+	}
+	free(path);
+}
+
+/**
+   Get the state of the bundle at `bundle_path` for detecting changes.
+
+   This includes the bundle directory itself, which changes when files are
+   added or removed, and its manifest.  If `data` is true, it also includes
+   the newest times of everything in the bundle, so data files modified in
+   place are detected, at the cost of visiting every file in the bundle.
+*/
+int
+lilv_bundle_stamp(const char* bundle_path, bool data, LilvBundleStamp* stamp)
+{
+	char*       manifest_path = lilv_path_join(bundle_path, "manifest.ttl");
+	struct stat dir_st;
+	struct stat manifest_st;
+	const int   st = (stat(bundle_path, &dir_st) ||
+	                  stat(manifest_path, &manifest_st)) ? errno : 0;
+
+	free(manifest_path);
+	if (st) {
+		return st;
+	}
+
+	memset(stamp, 0, sizeof(LilvBundleStamp));
+	stamp->dev            = (uint64_t)dir_st.st_dev;
+	stamp->ino            = (uint64_t)dir_st.st_ino;
+	stamp->mtime          = lilv_stat_mtime(&dir_st);
+	stamp->ctime          = lilv_stat_ctime(&dir_st);
+	stamp->manifest_ino   = (uint64_t)manifest_st.st_ino;
+	stamp->manifest_mtime = lilv_stat_mtime(&manifest_st);
+	stamp->manifest_ctime = lilv_stat_ctime(&manifest_st);
+	stamp->manifest_size  = (int64_t)manifest_st.st_size;
+	if (data) {
+		lilv_dir_for_each(bundle_path, stamp, lilv_bundle_stamp_file);
+	}
+	return 0;
+}
+
+/** Return true iff `a` and `b` have the same bundle directory and manifest. */
+bool
+lilv_bundle_manifest_stamp_equals(const LilvBundleStamp* a,
+                                  const LilvBundleStamp* b)
+{
+	return (a->dev == b->dev &&
+	        a->ino == b->ino &&
+	        a->mtime == b->mtime &&
+	        a->ctime == b->ctime &&
+	        a->manifest_ino == b->manifest_ino &&
+	        a->manifest_mtime == b->manifest_mtime &&
+	        a->manifest_ctime == b->manifest_ctime &&
+	        a->manifest_size == b->manifest_size);
+}
+
+bool
+lilv_bundle_stamp_equals(const LilvBundleStamp* a, const LilvBundleStamp* b)
+{
+	return (lilv_bundle_manifest_stamp_equals(a, b) &&
+	        a->data_mtime == b->data_mtime &&
+	        a->data_ctime == b->data_ctime);
+}
+
+/** Return the newest time in `stamp` in nanoseconds. */
+int64_t
+lilv_bundle_stamp_newest(const LilvBundleStamp* stamp)
+{
+	const int64_t times[] = { stamp->mtime,          stamp->ctime,
+	                          stamp->manifest_mtime, stamp->manifest_ctime,
+	                          stamp->data_mtime,     stamp->data_ctime };
+
+	int64_t newest = times[0];
+	for (size_t i = 1; i < sizeof(times) / sizeof(times[0]); ++i) {
+		if (times[i] > newest) {
+			newest = times[i];
+		}
+	}
+	return newest;
+}
+
+/** Return the current time in nanoseconds, comparable with file times. */
+int64_t
+lilv_current_time(void)
+{
+#ifdef _WIN32
+	return (int64_t)time(NULL) * 1000000000;
+#else
+	struct timeval now;
+	gettimeofday(&now, NULL);
+	return (int64_t)now.tv_sec * 1000000000 + (int64_t)now.tv_usec * 1000;
+#endif
+}
+
 bool
 lilv_file_equals(const char* a_path, const char* b_path)
 {
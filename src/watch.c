@@ -0,0 +1,436 @@
+/*
+  Copyright 2007-2019 David Robillard <http://drobilla.net>
+
+  Permission to use, copy, modify, and/or distribute this software for any
+  purpose with or without fee is hereby granted, provided that the above
+  copyright notice and this permission notice appear in all copies.
+
+  THIS SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+  WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+  MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+  ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+  WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+  ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+  OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+
+#include "lilv_config.h"
+#include "lilv_internal.h"
+
+#if defined(HAVE_INOTIFY) && defined(HAVE_PTHREAD)
+#    include <errno.h>
+#    include <poll.h>
+#    include <pthread.h>
+#    include <sys/inotify.h>
+#    include <unistd.h>
+#endif
+
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+
+/*
+  The watcher thread only records which bundle directories have changed.  It
+  never touches the world, the paths it collects are applied by the host
+  calling lilv_world_apply_pending_changes(), so there is no locking beyond
+  handing over the set of changed paths.
+
+  Inotify is not recursive, so every subdirectory of a bundle is watched as
+  well, and a change anywhere in it marks the whole bundle as changed.
+*/
+
+#if defined(HAVE_INOTIFY) && defined(HAVE_PTHREAD)
+
+/** Events that may add or remove a bundle in an LV2_PATH directory. */
+#define LILV_WATCH_DIR_EVENTS \
+	(IN_CREATE | IN_DELETE | IN_MOVED_FROM | IN_MOVED_TO | IN_ONLYDIR)
+
+/** Events that may change the contents of a bundle. */
+#define LILV_WATCH_BUNDLE_EVENTS \
+	(IN_ATTRIB | IN_CLOSE_WRITE | IN_CREATE | IN_DELETE | IN_MODIFY | \
+	 IN_MOVED_FROM | IN_MOVED_TO | IN_ONLYDIR)
+
+typedef struct {
+	int   wd;      ///< Inotify watch descriptor
+	char* path;    ///< Directory path, bundle paths have a trailing slash
+	char* bundle;  ///< Path of containing bundle, or NULL for LV2_PATH dirs
+} LilvWatch;
+
+/** A set of paths. */
+typedef struct {
+	char** paths;
+	size_t n_paths;
+} LilvPathSet;
+
+struct LilvWatcherImpl {
+	int             fd;          ///< Inotify instance
+	int             stop[2];     ///< Pipe written to stop the thread
+	unsigned        quiet_ms;    ///< Quiet period before publishing changes
+	LilvWatch*      watches;     ///< Watched directories
+	size_t          n_watches;   ///< Number of watched directories
+	LilvPathSet     collecting;  ///< Changes in the current batch
+	LilvPathSet     ready;       ///< Published changes, guarded by mutex
+	pthread_mutex_t mutex;       ///< Guards ready
+	pthread_t       thread;      ///< Watcher thread
+};
+
+static void
+lilv_path_set_add(LilvPathSet* set, const char* path)
+{
+	for (size_t i = 0; i < set->n_paths; ++i) {
+		if (!strcmp(set->paths[i], path)) {
+			return;
+		}
+	}
+
+	set->paths = (char**)realloc(set->paths,
+	                             (set->n_paths + 1) * sizeof(char*));
+	set->paths[set->n_paths++] = lilv_strdup(path);
+}
+
+static void
+lilv_path_set_clear(LilvPathSet* set)
+{
+	for (size_t i = 0; i < set->n_paths; ++i) {
+		free(set->paths[i]);
+	}
+	free(set->paths);
+	set->paths   = NULL;
+	set->n_paths = 0;
+}
+
+static LilvWatch*
+lilv_watcher_find(LilvWatcher* watcher, int wd)
+{
+	for (size_t i = 0; i < watcher->n_watches; ++i) {
+		if (watcher->watches[i].wd == wd) {
+			return &watcher->watches[i];
+		}
+	}
+	return NULL;
+}
+
+static void
+lilv_watcher_add_subdirs(LilvWatcher* watcher,
+                         const char*  path,
+                         const char*  bundle);
+
+/**
+   Watch the directory at `path`, silently ignoring files.
+
+   If `bundle` is NULL, `path` is an LV2_PATH directory.  Otherwise, it is
+   `bundle` or a directory inside it, and its subdirectories are watched too.
+*/
+static void
+lilv_watcher_add(LilvWatcher* watcher, const char* path, const char* bundle)
+{
+	const uint32_t mask = bundle ? LILV_WATCH_BUNDLE_EVENTS
+	                             : LILV_WATCH_DIR_EVENTS;
+
+	const int wd = inotify_add_watch(watcher->fd, path, mask);
+	if (wd < 0) {
+		if (errno != ENOTDIR && errno != ENOENT) {
+			LILV_WARNF("Failed to watch %s (%s)\n", path, strerror(errno));
+		}
+		return;
+	}
+
+	LilvWatch* watch = lilv_watcher_find(watcher, wd);
+	const bool added = !watch;
+	if (watch) {
+		// Same directory under a new name, for example after being moved
+		free(watch->path);
+		free(watch->bundle);
+	} else {
+		watcher->watches = (LilvWatch*)realloc(
+			watcher->watches, (watcher->n_watches + 1) * sizeof(LilvWatch));
+		watch     = &watcher->watches[watcher->n_watches++];
+		watch->wd = wd;
+	}
+
+	watch->path   = lilv_strdup(path);
+	watch->bundle = bundle ? lilv_strdup(bundle) : NULL;
+
+	if (bundle && added) {
+		// Only descend into new directories, so symbolic link loops end
+		lilv_watcher_add_subdirs(watcher, path, bundle);
+	}
+}
+
+static void
+lilv_watcher_remove(LilvWatcher* watcher, LilvWatch* watch)
+{
+	free(watch->path);
+	free(watch->bundle);
+	*watch = watcher->watches[--watcher->n_watches];
+}
+
+typedef struct {
+	LilvWatcher* watcher;
+	const char*  bundle;
+} LilvWatchSubdirs;
+
+static void
+lilv_watcher_add_subdir(const char* dir, const char* name, void* data)
+{
+	const LilvWatchSubdirs* subdirs = (const LilvWatchSubdirs*)data;
+	if (!strcmp(name, ".") || !strcmp(name, "..")) {
+		return;
+	}
+
+	char* path = lilv_strjoin(dir, name, "/", NULL);  // Dir has a trailing slash
+	if (lilv_is_directory(path)) {
+		lilv_watcher_add(subdirs->watcher, path, subdirs->bundle);
+	}
+	free(path);
+}
+
+/** Watch every subdirectory of `path` in `bundle`, recursively. */
+static void
+lilv_watcher_add_subdirs(LilvWatcher* watcher,
+                         const char*  path,
+                         const char*  bundle)
+{
+	LilvWatchSubdirs subdirs = { watcher, bundle };
+	lilv_dir_for_each(path, &subdirs, lilv_watcher_add_subdir);
+}
+
+typedef struct {
+	LilvWatcher* watcher;
+	bool         changed;  ///< Mark entries as changed
+} LilvWatchDirEntries;
+
+static void
+lilv_watcher_add_dir_entry(const char* dir, const char* name, void* data)
+{
+	LilvWatchDirEntries* entries = (LilvWatchDirEntries*)data;
+	if (!strcmp(name, ".") || !strcmp(name, "..")) {
+		return;
+	}
+
+	char* path = lilv_strjoin(dir, "/", name, "/", NULL);
+	lilv_watcher_add(entries->watcher, path, path);
+	if (entries->changed) {
+		lilv_path_set_add(&entries->watcher->collecting, path);
+	}
+	free(path);
+}
+
+/** Watch every bundle in LV2_PATH directory `dir`. */
+static void
+lilv_watcher_add_bundles(LilvWatcher* watcher, const char* dir, bool changed)
+{
+	LilvWatchDirEntries entries = { watcher, changed };
+	lilv_dir_for_each(dir, &entries, lilv_watcher_add_dir_entry);
+}
+
+static void
+lilv_watcher_handle(LilvWatcher* watcher, const struct inotify_event* event)
+{
+	if (event->mask & IN_Q_OVERFLOW) {
+		// Events were lost, so consider every bundle changed
+		for (size_t i = 0; i < watcher->n_watches; ++i) {
+			if (!watcher->watches[i].bundle) {
+				lilv_watcher_add_bundles(
+					watcher, watcher->watches[i].path, true);
+			}
+		}
+		return;
+	}
+
+	LilvWatch* watch = lilv_watcher_find(watcher, event->wd);
+	if (!watch) {
+		return;
+	} else if (event->mask & IN_IGNORED) {
+		lilv_watcher_remove(watcher, watch);
+	} else if (watch->bundle) {
+		if (event->len > 0 && (event->mask & IN_ISDIR) &&
+		    (event->mask & (IN_CREATE | IN_MOVED_TO))) {
+			// New subdirectory, which may already have contents
+			char* path = lilv_strjoin(watch->path, event->name, "/", NULL);
+			lilv_watcher_add(watcher, path, watch->bundle);
+			free(path);
+		}
+		lilv_path_set_add(&watcher->collecting, watch->bundle);
+	} else if (event->len > 0) {
+		char* path = lilv_strjoin(watch->path, "/", event->name, "/", NULL);
+		if (event->mask & (IN_CREATE | IN_MOVED_TO)) {
+			lilv_watcher_add(watcher, path, path);
+		}
+		lilv_path_set_add(&watcher->collecting, path);
+		free(path);
+	}
+}
+
+/** Make the changes collected in the current batch visible to the host. */
+static void
+lilv_watcher_publish(LilvWatcher* watcher)
+{
+	pthread_mutex_lock(&watcher->mutex);
+	for (size_t i = 0; i < watcher->collecting.n_paths; ++i) {
+		lilv_path_set_add(&watcher->ready, watcher->collecting.paths[i]);
+	}
+	pthread_mutex_unlock(&watcher->mutex);
+
+	lilv_path_set_clear(&watcher->collecting);
+}
+
+static void*
+lilv_watcher_run(void* data)
+{
+	LilvWatcher* watcher = (LilvWatcher*)data;
+	union {
+		struct inotify_event event;
+		char                 buf[4096];
+	} events;
+
+	struct pollfd fds[2] = { { watcher->fd, POLLIN, 0 },
+	                         { watcher->stop[0], POLLIN, 0 } };
+
+	for (;;) {
+		// Wait forever if idle, or until the batch has been quiet for long enough
+		const int timeout = watcher->collecting.n_paths
+			? (int)watcher->quiet_ms
+			: -1;
+
+		const int n_ready = poll(fds, 2, timeout);
+		if (n_ready < 0 && errno != EINTR) {
+			LILV_ERRORF("Failed to poll for changes (%s)\n", strerror(errno));
+			break;
+		} else if (fds[1].revents) {
+			break;
+		} else if (n_ready == 0) {
+			lilv_watcher_publish(watcher);
+		} else if (n_ready > 0 && (fds[0].revents & POLLIN)) {
+			const ssize_t len = read(watcher->fd, events.buf, sizeof(events));
+			for (ssize_t offset = 0; offset < len;) {
+				const struct inotify_event* const event =
+					(const struct inotify_event*)(events.buf + offset);
+
+				lilv_watcher_handle(watcher, event);
+				offset += (ssize_t)(sizeof(struct inotify_event) + event->len);
+			}
+		}
+	}
+
+	return NULL;
+}
+
+LilvWatcher*
+lilv_watcher_new(char** dirs, size_t n_dirs, unsigned quiet_ms)
+{
+	LilvWatcher* watcher = (LilvWatcher*)calloc(1, sizeof(LilvWatcher));
+	watcher->quiet_ms = quiet_ms;
+	watcher->fd       = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+	if (watcher->fd < 0) {
+		LILV_ERRORF("Failed to initialize inotify (%s)\n", strerror(errno));
+		free(watcher);
+		return NULL;
+	} else if (pipe(watcher->stop)) {
+		LILV_ERRORF("Failed to create pipe (%s)\n", strerror(errno));
+		close(watcher->fd);
+		free(watcher);
+		return NULL;
+	}
+
+	for (size_t i = 0; i < n_dirs; ++i) {
+		lilv_watcher_add(watcher, dirs[i], NULL);
+		lilv_watcher_add_bundles(watcher, dirs[i], false);
+	}
+
+	pthread_mutex_init(&watcher->mutex, NULL);
+	if (pthread_create(&watcher->thread, NULL, lilv_watcher_run, watcher)) {
+		LILV_ERROR("Failed to start watcher thread\n");
+		pthread_mutex_destroy(&watcher->mutex);
+		close(watcher->stop[0]);
+		close(watcher->stop[1]);
+		watcher->stop[0] = watcher->stop[1] = -1;
+		lilv_watcher_free(watcher);
+		return NULL;
+	}
+
+	return watcher;
+}
+
+void
+lilv_watcher_free(LilvWatcher* watcher)
+{
+	if (!watcher) {
+		return;
+	}
+
+	if (watcher->stop[1] >= 0) {
+		// Closing the write end always wakes the thread, unlike writing to it
+		close(watcher->stop[1]);
+		pthread_join(watcher->thread, NULL);
+		pthread_mutex_destroy(&watcher->mutex);
+		close(watcher->stop[0]);
+	}
+
+	for (size_t i = 0; i < watcher->n_watches; ++i) {
+		free(watcher->watches[i].path);
+		free(watcher->watches[i].bundle);
+	}
+
+	close(watcher->fd);
+	lilv_path_set_clear(&watcher->collecting);
+	lilv_path_set_clear(&watcher->ready);
+	free(watcher->watches);
+	free(watcher);
+}
+
+bool
+lilv_watcher_has_changes(LilvWatcher* watcher)
+{
+	pthread_mutex_lock(&watcher->mutex);
+	const bool has_changes = watcher->ready.n_paths > 0;
+	pthread_mutex_unlock(&watcher->mutex);
+	return has_changes;
+}
+
+char**
+lilv_watcher_take_changes(LilvWatcher* watcher, size_t* n_paths)
+{
+	pthread_mutex_lock(&watcher->mutex);
+	char** const paths = watcher->ready.paths;
+	*n_paths               = watcher->ready.n_paths;
+	watcher->ready.paths   = NULL;
+	watcher->ready.n_paths = 0;
+	pthread_mutex_unlock(&watcher->mutex);
+	return paths;
+}
+
+#else  // !HAVE_INOTIFY || !HAVE_PTHREAD
+
+LilvWatcher*
+lilv_watcher_new(char** dirs, size_t n_dirs, unsigned quiet_ms)
+{
+	(void)dirs;
+	(void)n_dirs;
+	(void)quiet_ms;
+	LILV_ERROR("Watching for changes is not supported on this system\n");
+	return NULL;
+}
+
+void
+lilv_watcher_free(LilvWatcher* watcher)
+{
+	(void)watcher;
+}
+
+bool
+lilv_watcher_has_changes(LilvWatcher* watcher)
+{
+	(void)watcher;
+	return false;
+}
+
+char**
+lilv_watcher_take_changes(LilvWatcher* watcher, size_t* n_paths)
+{
+	(void)watcher;
+	*n_paths = 0;
+	return NULL;
+}
+
+#endif  // HAVE_INOTIFY && HAVE_PTHREAD
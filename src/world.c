@@ -21,10 +21,15 @@
 #include "serd/serd.h"
 #include "sord/sord.h"
 #include "zix/common.h"
+#include "zix/hash.h"
 #include "zix/tree.h"
 
+#include "lv2/atom/atom.h"
 #include "lv2/core/lv2.h"
+#include "lv2/event/event.h"
+#include "lv2/port-props/port-props.h"
 #include "lv2/presets/presets.h"
+#include "lv2/ui/ui.h"
 
 #ifdef LILV_DYN_MANIFEST
 #    include "lv2/dynmanifest/dynmanifest.h"
@@ -38,9 +43,185 @@
 #include <stdint.h>
 #include <stdio.h>
 
+/** Time without changes before the watcher makes them pending, in ms. */
+#define LILV_WATCH_QUIET_PERIOD_MS 200
+
 static int
 lilv_world_drop_graph(LilvWorld* world, const SordNode* graph);
 
+/** A feature URI with a bit index for feature bitsets. */
+typedef struct {
+	SordNode* uri;  ///< Feature URI (owned reference)
+	uint32_t  id;   ///< Bit index in feature bitsets
+} LilvFeatureId;
+
+static uint32_t
+lilv_feature_id_hash(const void* value)
+{
+	return lilv_ptr_hash(((const LilvFeatureId*)value)->uri);
+}
+
+static bool
+lilv_feature_id_equals(const void* a, const void* b)
+{
+	return ((const LilvFeatureId*)a)->uri == ((const LilvFeatureId*)b)->uri;
+}
+
+static void
+lilv_feature_id_free(void* value, void* user_data)
+{
+	sord_node_free((SordWorld*)user_data, ((LilvFeatureId*)value)->uri);
+}
+
+/** An object with a LilvHeader, indexed by the address of its URI node. */
+typedef struct {
+	const SordNode* uri;     ///< URI node of object
+	void*           object;  ///< Object (not owned)
+} LilvUriEntry;
+
+static uint32_t
+lilv_uri_entry_hash(const void* value)
+{
+	return lilv_ptr_hash(((const LilvUriEntry*)value)->uri);
+}
+
+static bool
+lilv_uri_entry_equals(const void* a, const void* b)
+{
+	return ((const LilvUriEntry*)a)->uri == ((const LilvUriEntry*)b)->uri;
+}
+
+static ZixHash*
+lilv_uri_index_new(void)
+{
+	return zix_hash_new(
+		lilv_uri_entry_hash, lilv_uri_entry_equals, sizeof(LilvUriEntry));
+}
+
+static void
+lilv_uri_index_insert(ZixHash* index, void* object)
+{
+	const LilvUriEntry entry = { ((struct LilvHeader*)object)->uri->node,
+	                             object };
+	zix_hash_insert(index, &entry, NULL);
+}
+
+static void
+lilv_uri_index_remove(ZixHash* index, const void* object)
+{
+	const LilvUriEntry key = { ((const struct LilvHeader*)object)->uri->node,
+	                           NULL };
+	zix_hash_remove(index, &key);
+}
+
+void*
+lilv_uri_index_find(const ZixHash* index, const SordNode* uri)
+{
+	const LilvUriEntry        key   = { uri, NULL };
+	const LilvUriEntry* const entry =
+		(const LilvUriEntry*)zix_hash_find(index, &key);
+
+	return entry ? entry->object : NULL;
+}
+
+/** Unloaded specifications with the same URI, for lazy loading. */
+typedef struct {
+	char*     uri;    ///< Specification URI (owned)
+	size_t    len;    ///< Length of uri in bytes
+	LilvSpec* specs;  ///< Unloaded specifications, linked by next_lazy
+} LilvLazySpecs;
+
+static uint32_t
+lilv_lazy_specs_hash(const void* value)
+{
+	const LilvLazySpecs* const entry = (const LilvLazySpecs*)value;
+
+	uint32_t h = 2166136261u;  // 32-bit FNV-1a
+	for (size_t i = 0; i < entry->len; ++i) {
+		h = (h ^ (uint8_t)entry->uri[i]) * 16777619u;
+	}
+	return h;
+}
+
+static bool
+lilv_lazy_specs_equals(const void* a, const void* b)
+{
+	const LilvLazySpecs* const ea = (const LilvLazySpecs*)a;
+	const LilvLazySpecs* const eb = (const LilvLazySpecs*)b;
+	return ea->len == eb->len && !memcmp(ea->uri, eb->uri, ea->len);
+}
+
+static void
+lilv_lazy_specs_free(void* value, void* user_data)
+{
+	free(((LilvLazySpecs*)value)->uri);
+}
+
+/** Add `spec` to the index of unloaded specifications. */
+static void
+lilv_world_add_lazy_spec(LilvWorld* world, LilvSpec* spec)
+{
+	const char*    uri   = (const char*)sord_node_get_string(spec->spec);
+	LilvLazySpecs  key   = { (char*)uri, strlen(uri), NULL };
+	LilvLazySpecs* entry = (LilvLazySpecs*)zix_hash_find(world->lazy_specs,
+	                                                     &key);
+	if (!entry) {
+		key.uri = lilv_strdup(uri);
+		if (zix_hash_insert(world->lazy_specs, &key, (void**)&entry)) {
+			free(key.uri);
+			spec->next_lazy = NULL;
+			return;  // Out of memory, only loaded with all specifications
+		}
+	}
+
+	spec->next_lazy = entry->specs;
+	entry->specs    = spec;
+}
+
+/** Remove `spec` from the index of unloaded specifications. */
+static void
+lilv_world_remove_lazy_spec(LilvWorld* world, LilvSpec* spec)
+{
+	const char*         uri   = (const char*)sord_node_get_string(spec->spec);
+	const LilvLazySpecs key   = { (char*)uri, strlen(uri), NULL };
+	LilvLazySpecs*      entry = (LilvLazySpecs*)zix_hash_find(
+		world->lazy_specs, &key);
+	if (!entry) {
+		return;
+	}
+
+	for (LilvSpec** s = &entry->specs; *s; s = &(*s)->next_lazy) {
+		if (*s == spec) {
+			*s = spec->next_lazy;
+			break;
+		}
+	}
+
+	if (!entry->specs) {
+		char* const entry_uri = entry->uri;
+		zix_hash_remove(world->lazy_specs, entry);
+		free(entry_uri);
+	}
+}
+
+static uint32_t
+lilv_interned_node_hash(const void* value)
+{
+	return lilv_ptr_hash(((const LilvNode*)value)->node);
+}
+
+static bool
+lilv_interned_node_equals(const void* a, const void* b)
+{
+	return ((const LilvNode*)a)->node == ((const LilvNode*)b)->node;
+}
+
+static void
+lilv_interned_node_free(void* value, void* user_data)
+{
+	sord_node_free((SordWorld*)user_data, ((LilvNode*)value)->node);
+}
+
 LILV_API LilvWorld*
 lilv_world_new(void)
 {
@@ -51,64 +232,111 @@ lilv_world_new(void)
 		goto fail;
 	}
 
+	/* Since graphs are enabled, sord also maintains graph-first indices, so
+	   dropping the statements of a bundle or file is a range scan. */
 	world->model = sord_new(world->world, SORD_SPO|SORD_OPS, true);
 	if (!world->model) {
 		goto fail;
 	}
 
+	world->nodes = zix_hash_new(
+		lilv_interned_node_hash, lilv_interned_node_equals, sizeof(LilvNode));
+
 	world->specs          = NULL;
 	world->plugin_classes = lilv_plugin_classes_new();
 	world->plugins        = lilv_plugins_new();
 	world->zombies        = lilv_plugins_new();
+	world->plugins_by_uri = lilv_uri_index_new();
+	world->zombies_by_uri = lilv_uri_index_new();
+	world->classes_by_uri = lilv_uri_index_new();
 	world->loaded_files   = zix_tree_new(
 		false, lilv_resource_node_cmp, NULL, (ZixDestroyFunc)lilv_node_free);
 
 	world->libs = zix_tree_new(false, lilv_lib_compare, NULL, NULL);
 
+	world->feature_ids = zix_hash_new(
+		lilv_feature_id_hash, lilv_feature_id_equals, sizeof(LilvFeatureId));
+
+	world->lazy_specs = zix_hash_new(
+		lilv_lazy_specs_hash, lilv_lazy_specs_equals, sizeof(LilvLazySpecs));
+
+	world->versions = zix_tree_new(false,
+	                               lilv_version_table_cmp,
+	                               NULL,
+	                               (ZixDestroyFunc)lilv_version_table_free);
+
+	world->bundle_files = zix_tree_new(false,
+	                                   lilv_bundle_files_cmp,
+	                                   NULL,
+	                                   (ZixDestroyFunc)lilv_bundle_files_free);
+
 #define NS_DCTERMS "http://purl.org/dc/terms/"
 #define NS_DYNMAN  "http://lv2plug.in/ns/ext/dynmanifest#"
 #define NS_OWL     "http://www.w3.org/2002/07/owl#"
 
 #define NEW_URI(uri) sord_new_uri(world->world, (const uint8_t*)(uri))
 
-	world->uris.dc_replaces         = NEW_URI(NS_DCTERMS   "replaces");
-	world->uris.dman_DynManifest    = NEW_URI(NS_DYNMAN    "DynManifest");
-	world->uris.doap_name           = NEW_URI(LILV_NS_DOAP "name");
-	world->uris.lv2_Plugin          = NEW_URI(LV2_CORE__Plugin);
-	world->uris.lv2_Specification   = NEW_URI(LV2_CORE__Specification);
-	world->uris.lv2_appliesTo       = NEW_URI(LV2_CORE__appliesTo);
-	world->uris.lv2_binary          = NEW_URI(LV2_CORE__binary);
-	world->uris.lv2_default         = NEW_URI(LV2_CORE__default);
-	world->uris.lv2_designation     = NEW_URI(LV2_CORE__designation);
-	world->uris.lv2_extensionData   = NEW_URI(LV2_CORE__extensionData);
-	world->uris.lv2_index           = NEW_URI(LV2_CORE__index);
-	world->uris.lv2_latency         = NEW_URI(LV2_CORE__latency);
-	world->uris.lv2_maximum         = NEW_URI(LV2_CORE__maximum);
-	world->uris.lv2_microVersion    = NEW_URI(LV2_CORE__microVersion);
-	world->uris.lv2_minimum         = NEW_URI(LV2_CORE__minimum);
-	world->uris.lv2_minorVersion    = NEW_URI(LV2_CORE__minorVersion);
-	world->uris.lv2_name            = NEW_URI(LV2_CORE__name);
-	world->uris.lv2_optionalFeature = NEW_URI(LV2_CORE__optionalFeature);
-	world->uris.lv2_port            = NEW_URI(LV2_CORE__port);
-	world->uris.lv2_portProperty    = NEW_URI(LV2_CORE__portProperty);
-	world->uris.lv2_reportsLatency  = NEW_URI(LV2_CORE__reportsLatency);
-	world->uris.lv2_requiredFeature = NEW_URI(LV2_CORE__requiredFeature);
-	world->uris.lv2_symbol          = NEW_URI(LV2_CORE__symbol);
-	world->uris.lv2_prototype       = NEW_URI(LV2_CORE__prototype);
-	world->uris.owl_Ontology        = NEW_URI(NS_OWL "Ontology");
-	world->uris.pset_value          = NEW_URI(LV2_PRESETS__value);
-	world->uris.rdf_a               = NEW_URI(LILV_NS_RDF  "type");
-	world->uris.rdf_value           = NEW_URI(LILV_NS_RDF  "value");
-	world->uris.rdfs_Class          = NEW_URI(LILV_NS_RDFS "Class");
-	world->uris.rdfs_label          = NEW_URI(LILV_NS_RDFS "label");
-	world->uris.rdfs_seeAlso        = NEW_URI(LILV_NS_RDFS "seeAlso");
-	world->uris.rdfs_subClassOf     = NEW_URI(LILV_NS_RDFS "subClassOf");
-	world->uris.xsd_base64Binary    = NEW_URI(LILV_NS_XSD  "base64Binary");
-	world->uris.xsd_boolean         = NEW_URI(LILV_NS_XSD  "boolean");
-	world->uris.xsd_decimal         = NEW_URI(LILV_NS_XSD  "decimal");
-	world->uris.xsd_double          = NEW_URI(LILV_NS_XSD  "double");
-	world->uris.xsd_integer         = NEW_URI(LILV_NS_XSD  "integer");
-	world->uris.null_uri            = NULL;
+	world->uris.atom_AtomPort          = NEW_URI(LV2_ATOM__AtomPort);
+	world->uris.dc_replaces            = NEW_URI(NS_DCTERMS   "replaces");
+	world->uris.dman_DynManifest       = NEW_URI(NS_DYNMAN    "DynManifest");
+	world->uris.doap_name              = NEW_URI(LILV_NS_DOAP "name");
+	world->uris.ev_EventPort           = NEW_URI(LV2_EVENT__EventPort);
+	world->uris.lv2_AudioPort          = NEW_URI(LV2_CORE__AudioPort);
+	world->uris.lv2_CVPort             = NEW_URI(LV2_CORE__CVPort);
+	world->uris.lv2_ControlPort        = NEW_URI(LV2_CORE__ControlPort);
+	world->uris.lv2_InputPort          = NEW_URI(LV2_CORE__InputPort);
+	world->uris.lv2_OutputPort         = NEW_URI(LV2_CORE__OutputPort);
+	world->uris.lv2_Plugin             = NEW_URI(LV2_CORE__Plugin);
+	world->uris.lv2_Specification      = NEW_URI(LV2_CORE__Specification);
+	world->uris.lv2_appliesTo          = NEW_URI(LV2_CORE__appliesTo);
+	world->uris.lv2_binary             = NEW_URI(LV2_CORE__binary);
+	world->uris.lv2_connectionOptional = NEW_URI(LV2_CORE__connectionOptional);
+	world->uris.lv2_default            = NEW_URI(LV2_CORE__default);
+	world->uris.lv2_designation        = NEW_URI(LV2_CORE__designation);
+	world->uris.lv2_enumeration        = NEW_URI(LV2_CORE__enumeration);
+	world->uris.lv2_extensionData      = NEW_URI(LV2_CORE__extensionData);
+	world->uris.lv2_index              = NEW_URI(LV2_CORE__index);
+	world->uris.lv2_integer            = NEW_URI(LV2_CORE__integer);
+	world->uris.lv2_isSideChain        = NEW_URI(LV2_CORE__isSideChain);
+	world->uris.lv2_latency            = NEW_URI(LV2_CORE__latency);
+	world->uris.lv2_maximum            = NEW_URI(LV2_CORE__maximum);
+	world->uris.lv2_microVersion       = NEW_URI(LV2_CORE__microVersion);
+	world->uris.lv2_minimum            = NEW_URI(LV2_CORE__minimum);
+	world->uris.lv2_minorVersion       = NEW_URI(LV2_CORE__minorVersion);
+	world->uris.lv2_name               = NEW_URI(LV2_CORE__name);
+	world->uris.lv2_optionalFeature    = NEW_URI(LV2_CORE__optionalFeature);
+	world->uris.lv2_port               = NEW_URI(LV2_CORE__port);
+	world->uris.lv2_portProperty       = NEW_URI(LV2_CORE__portProperty);
+	world->uris.lv2_project            = NEW_URI(LV2_CORE__project);
+	world->uris.lv2_reportsLatency     = NEW_URI(LV2_CORE__reportsLatency);
+	world->uris.lv2_requiredFeature    = NEW_URI(LV2_CORE__requiredFeature);
+	world->uris.lv2_sampleRate         = NEW_URI(LV2_CORE__sampleRate);
+	world->uris.lv2_symbol             = NEW_URI(LV2_CORE__symbol);
+	world->uris.lv2_toggled            = NEW_URI(LV2_CORE__toggled);
+	world->uris.lv2_prototype          = NEW_URI(LV2_CORE__prototype);
+	world->uris.owl_Ontology           = NEW_URI(NS_OWL "Ontology");
+	world->uris.pprops_causesArtifacts = NEW_URI(LV2_PORT_PROPS__causesArtifacts);
+	world->uris.pprops_expensive       = NEW_URI(LV2_PORT_PROPS__expensive);
+	world->uris.pprops_logarithmic     = NEW_URI(LV2_PORT_PROPS__logarithmic);
+	world->uris.pprops_notOnGUI        = NEW_URI(LV2_PORT_PROPS__notOnGUI);
+	world->uris.pprops_trigger         = NEW_URI(LV2_PORT_PROPS__trigger);
+	world->uris.pset_Preset            = NEW_URI(LV2_PRESETS__Preset);
+	world->uris.pset_bank              = NEW_URI(LV2_PRESETS__bank);
+	world->uris.pset_value             = NEW_URI(LV2_PRESETS__value);
+	world->uris.rdf_a                  = NEW_URI(LILV_NS_RDF  "type");
+	world->uris.rdf_value              = NEW_URI(LILV_NS_RDF  "value");
+	world->uris.rdfs_Class             = NEW_URI(LILV_NS_RDFS "Class");
+	world->uris.rdfs_label             = NEW_URI(LILV_NS_RDFS "label");
+	world->uris.rdfs_seeAlso           = NEW_URI(LILV_NS_RDFS "seeAlso");
+	world->uris.rdfs_subClassOf        = NEW_URI(LILV_NS_RDFS "subClassOf");
+	world->uris.ui_binary              = NEW_URI(LV2_UI__binary);
+	world->uris.ui_ui                  = NEW_URI(LV2_UI__ui);
+	world->uris.xsd_base64Binary       = NEW_URI(LILV_NS_XSD  "base64Binary");
+	world->uris.xsd_boolean            = NEW_URI(LILV_NS_XSD  "boolean");
+	world->uris.xsd_decimal            = NEW_URI(LILV_NS_XSD  "decimal");
+	world->uris.xsd_double             = NEW_URI(LILV_NS_XSD  "double");
+	world->uris.xsd_integer            = NEW_URI(LILV_NS_XSD  "integer");
+	world->uris.null_uri               = NULL;
 
 	world->lv2_plugin_class = lilv_plugin_class_new(
 		world, NULL, world->uris.lv2_Plugin, "Plugin");
@@ -125,6 +353,15 @@ fail:
 	return NULL;
 }
 
+static void
+lilv_spec_free(LilvWorld* world, LilvSpec* spec)
+{
+	sord_node_free(world->world, spec->spec);
+	sord_node_free(world->world, spec->bundle);
+	lilv_nodes_free(spec->data_uris);
+	free(spec);
+}
+
 LILV_API void
 lilv_world_free(LilvWorld* world)
 {
@@ -132,6 +369,14 @@ lilv_world_free(LilvWorld* world)
 		return;
 	}
 
+	if (world->arena) {
+		lilv_arena_reset(world->arena);  // Release nodes held by results
+		world->arena = NULL;
+	}
+
+	lilv_watcher_free(world->watcher);
+	world->watcher = NULL;
+
 	lilv_plugin_class_free(world->lv2_plugin_class);
 	world->lv2_plugin_class = NULL;
 
@@ -141,10 +386,7 @@ lilv_world_free(LilvWorld* world)
 
 	for (LilvSpec* spec = world->specs; spec;) {
 		LilvSpec* next = spec->next;
-		sord_node_free(world->world, spec->spec);
-		sord_node_free(world->world, spec->bundle);
-		lilv_nodes_free(spec->data_uris);
-		free(spec);
+		lilv_spec_free(world, spec);
 		spec = next;
 	}
 	world->specs = NULL;
@@ -166,12 +408,57 @@ lilv_world_free(LilvWorld* world)
 	zix_tree_free((ZixTree*)world->loaded_files);
 	world->loaded_files = NULL;
 
+	for (size_t i = 0; i < world->n_bundles; ++i) {
+		lilv_node_free(world->bundles[i].uri);
+	}
+	free(world->bundles);
+	world->bundles   = NULL;
+	world->n_bundles = 0;
+
 	zix_tree_free(world->libs);
 	world->libs = NULL;
 
+	zix_tree_free(world->versions);
+	world->versions = NULL;
+
+	zix_tree_free(world->bundle_files);
+	world->bundle_files = NULL;
+
 	zix_tree_free((ZixTree*)world->plugin_classes);
 	world->plugin_classes = NULL;
 
+	zix_hash_free(world->plugins_by_uri);
+	zix_hash_free(world->zombies_by_uri);
+	zix_hash_free(world->classes_by_uri);
+	world->plugins_by_uri = NULL;
+	world->zombies_by_uri = NULL;
+	world->classes_by_uri = NULL;
+
+	free(world->all_classes);
+	world->all_classes = NULL;
+	world->n_classes   = 0;
+
+	zix_hash_foreach(world->feature_ids, lilv_feature_id_free, world->world);
+	zix_hash_free(world->feature_ids);
+	world->feature_ids = NULL;
+
+	zix_hash_foreach(world->lazy_specs, lilv_lazy_specs_free, NULL);
+	zix_hash_free(world->lazy_specs);
+	world->lazy_specs = NULL;
+
+	free(world->supported_features);
+	world->supported_features = NULL;
+	world->n_supported_words  = 0;
+
+	free(world->env_lang);
+	free(world->lang);
+	world->env_lang = NULL;
+	world->lang     = NULL;
+
+	zix_hash_foreach(world->nodes, lilv_interned_node_free, world->world);
+	zix_hash_free(world->nodes);
+	world->nodes = NULL;
+
 	sord_free(world->model);
 	world->model = NULL;
 
@@ -179,6 +466,7 @@ lilv_world_free(LilvWorld* world)
 	world->world = NULL;
 
 	free(world->opt.lv2_path);
+	free(world->opt.index_path);
 	free(world);
 }
 
@@ -202,44 +490,152 @@ lilv_world_set_option(LilvWorld*      world,
 			world->opt.lv2_path = lilv_strdup(lilv_node_as_string(value));
 			return;
 		}
+	} else if (!strcmp(uri, LILV_OPTION_DISCOVERY_INDEX)) {
+		if (lilv_node_is_string(value)) {
+			free(world->opt.index_path);
+			world->opt.index_path = lilv_strdup(lilv_node_as_string(value));
+			return;
+		} else if (lilv_node_is_bool(value)) {
+			free(world->opt.index_path);
+			world->opt.index_path = (lilv_node_as_bool(value)
+			                         ? lilv_index_default_path()
+			                         : NULL);
+			return;
+		}
+	} else if (!strcmp(uri, LILV_OPTION_DISCOVERY_THREADS)) {
+		if (lilv_node_is_int(value) && lilv_node_as_int(value) >= 0) {
+			world->opt.discovery_threads = (unsigned)lilv_node_as_int(value);
+			return;
+		}
+	} else if (!strcmp(uri, LILV_OPTION_LAZY_SPECS)) {
+		if (lilv_node_is_bool(value)) {
+			world->opt.lazy_specs = lilv_node_as_bool(value);
+			return;
+		}
 	}
 	LILV_WARNF("Unrecognized or invalid option `%s'\n", uri);
 }
 
-LILV_API LilvNodes*
-lilv_world_find_nodes(LilvWorld*      world,
-                      const LilvNode* subject,
-                      const LilvNode* predicate,
-                      const LilvNode* object)
+LILV_API void
+lilv_world_set_arena(LilvWorld* world, LilvArena* arena)
+{
+	world->arena = arena;
+}
+
+/** Return true iff a pattern for a node search is valid, printing errors. */
+static bool
+lilv_world_check_pattern(const LilvNode* subject,
+                         const LilvNode* predicate,
+                         const LilvNode* object)
 {
 	if (subject && !lilv_node_is_uri(subject) && !lilv_node_is_blank(subject)) {
 		LILV_ERRORF("Subject `%s' is not a resource\n",
 		            sord_node_get_string(subject->node));
-		return NULL;
+		return false;
 	} else if (!predicate) {
 		LILV_ERROR("Missing required predicate\n");
-		return NULL;
+		return false;
 	} else if (!lilv_node_is_uri(predicate)) {
 		LILV_ERRORF("Predicate `%s' is not a URI\n",
 		            sord_node_get_string(predicate->node));
-		return NULL;
+		return false;
 	} else if (!subject && !object) {
 		LILV_ERROR("Both subject and object are NULL\n");
+		return false;
+	}
+
+	return true;
+}
+
+/**
+   Load any lazy specifications that a query about a pattern may touch.
+
+   This is only called by public query functions before they search the
+   model, since loading data invalidates any iterators that are in use.
+*/
+static void
+lilv_world_load_specs_for_pattern(LilvWorld*      world,
+                                  const LilvNode* subject,
+                                  const LilvNode* object)
+{
+	if (world->opt.lazy_specs) {
+		lilv_world_load_specs_for(world,
+		                          subject ? subject->node
+		                          : object ? object->node
+		                          : NULL);
+	}
+}
+
+LILV_API LilvNodes*
+lilv_world_find_nodes(LilvWorld*      world,
+                      const LilvNode* subject,
+                      const LilvNode* predicate,
+                      const LilvNode* object)
+{
+	if (!lilv_world_check_pattern(subject, predicate, object)) {
 		return NULL;
 	}
 
+	lilv_world_load_specs_for_pattern(world, subject, object);
 	return lilv_world_find_nodes_internal(world,
 	                                      subject ? subject->node : NULL,
 	                                      predicate->node,
 	                                      object ? object->node : NULL);
 }
 
+/**
+   Return the system language to filter translations by, or NULL.
+
+   This is converted from LANG again only if LANG has changed since the last
+   call, so queries do not allocate a copy of it every time.  The result is
+   valid until the next call after LANG has changed.
+*/
+const char*
+lilv_world_get_lang(LilvWorld* world)
+{
+	const char* const env_lang = getenv("LANG");
+	if (!env_lang) {
+		free(world->env_lang);
+		free(world->lang);
+		world->env_lang = NULL;
+		world->lang     = NULL;
+	} else if (!world->env_lang || strcmp(env_lang, world->env_lang)) {
+		free(world->env_lang);
+		free(world->lang);
+		world->env_lang = lilv_strdup(env_lang);
+		world->lang     = lilv_get_lang();
+	}
+
+	return world->lang;
+}
+
+LILV_API LilvQuery*
+lilv_world_query(LilvWorld*      world,
+                 const LilvNode* subject,
+                 const LilvNode* predicate,
+                 const LilvNode* object)
+{
+	if (!lilv_world_check_pattern(subject, predicate, object)) {
+		return NULL;
+	}
+
+	lilv_world_load_specs_for_pattern(world, subject, object);
+	return lilv_query_new(world,
+	                      lilv_world_query_internal(world,
+	                                                subject ? subject->node : NULL,
+	                                                predicate->node,
+	                                                object ? object->node : NULL),
+	                      object ? SORD_SUBJECT : SORD_OBJECT);
+}
+
 LILV_API LilvNode*
 lilv_world_get(LilvWorld*      world,
                const LilvNode* subject,
                const LilvNode* predicate,
                const LilvNode* object)
 {
+	lilv_world_load_specs_for_pattern(world, subject, object);
+
 	SordNode* snode = sord_get(world->model,
 	                           subject   ? subject->node   : NULL,
 	                           predicate ? predicate->node : NULL,
@@ -274,6 +670,8 @@ lilv_world_ask(LilvWorld*      world,
                const LilvNode* predicate,
                const LilvNode* object)
 {
+	lilv_world_load_specs_for_pattern(world, subject, object);
+
 	return sord_ask(world->model,
 	                subject   ? subject->node   : NULL,
 	                predicate ? predicate->node : NULL,
@@ -356,12 +754,46 @@ lilv_lib_compare(const void* a, const void* b, void* user_data)
 	return cmp ? cmp : strcmp(lib_a->bundle_path, lib_b->bundle_path);
 }
 
+int
+lilv_version_table_cmp(const void* a, const void* b, void* user_data)
+{
+	return lilv_resource_node_cmp(((const LilvVersionTable*)a)->bundle,
+	                              ((const LilvVersionTable*)b)->bundle,
+	                              user_data);
+}
+
+void
+lilv_version_table_free(LilvVersionTable* table)
+{
+	for (size_t i = 0; i < table->n_plugins; ++i) {
+		lilv_node_free(table->plugins[i].plugin);
+	}
+	free(table->plugins);
+	lilv_node_free(table->bundle);
+	free(table);
+}
+
+int
+lilv_bundle_files_cmp(const void* a, const void* b, void* user_data)
+{
+	return strcmp(((const LilvBundleFiles*)a)->uri,
+	              ((const LilvBundleFiles*)b)->uri);
+}
+
+void
+lilv_bundle_files_free(LilvBundleFiles* files)
+{
+	zix_tree_free(files->files);
+	free(files->uri);
+	free(files);
+}
+
 /** Get an element of a collection of any object with an LilvHeader by URI. */
 static ZixTreeIter*
 lilv_collection_find_by_uri(const ZixTree* seq, const LilvNode* uri)
 {
 	ZixTreeIter* i = NULL;
-	if (lilv_node_is_uri(uri)) {
+	if (seq && lilv_node_is_uri(uri)) {
 		struct LilvHeader key = { NULL, (LilvNode*)uri };
 		zix_tree_find(seq, &key, &i);
 	}
@@ -386,6 +818,7 @@ lilv_world_add_spec(LilvWorld*      world,
 	spec->spec      = sord_node_copy(specification_node);
 	spec->bundle    = sord_node_copy(bundle_node);
 	spec->data_uris = lilv_nodes_new();
+	spec->loaded    = false;
 
 	// Add all data files (rdfs:seeAlso)
 	SordIter* files = sord_search(world->model,
@@ -395,15 +828,15 @@ lilv_world_add_spec(LilvWorld*      world,
 	                              NULL);
 	FOREACH_MATCH(files) {
 		const SordNode* file_node = sord_iter_get_node(files, SORD_OBJECT);
-		zix_tree_insert((ZixTree*)spec->data_uris,
-		                lilv_node_new_from_node(world, file_node),
-		                NULL);
+		lilv_array_insert((LilvArray*)spec->data_uris,
+		                  lilv_node_new_from_node(world, file_node));
 	}
 	sord_iter_free(files);
 
 	// Add specification to world specification list
 	spec->next   = world->specs;
 	world->specs = spec;
+	lilv_world_add_lazy_spec(world, spec);
 }
 
 static void
@@ -434,26 +867,31 @@ lilv_world_add_plugin(LilvWorld*      world,
 			lilv_node_free(plugin_uri);
 			return;
 		}
-	} else if ((z = lilv_collection_find_by_uri((const ZixTree*)world->zombies,
+	} else if (lilv_uri_index_find(world->zombies_by_uri, plugin_node) &&
+	           (z = lilv_collection_find_by_uri((const ZixTree*)world->zombies,
 	                                            plugin_uri))) {
 		// Plugin bundle has been re-loaded, move from zombies to plugins
 		plugin = (LilvPlugin*)zix_tree_get(z);
 		zix_tree_remove((ZixTree*)world->zombies, z);
+		lilv_uri_index_remove(world->zombies_by_uri, plugin);
 		zix_tree_insert((ZixTree*)world->plugins, plugin, NULL);
+		lilv_uri_index_insert(world->plugins_by_uri, plugin);
 		lilv_node_free(plugin_uri);
 		lilv_plugin_clear(plugin, lilv_node_new_from_node(world, bundle));
+		lilv_array_insert((LilvArray*)plugin->data_uris,
+		                  lilv_node_duplicate(manifest_uri));
 	} else {
 		// Add new plugin to the world
 		plugin = lilv_plugin_new(
 			world, plugin_uri, lilv_node_new_from_node(world, bundle));
 
 		// Add manifest as plugin data file (as if it were rdfs:seeAlso)
-		zix_tree_insert((ZixTree*)plugin->data_uris,
-		                lilv_node_duplicate(manifest_uri),
-		                NULL);
+		lilv_array_insert((LilvArray*)plugin->data_uris,
+		                  lilv_node_duplicate(manifest_uri));
 
 		// Add plugin to world plugin sequence
 		zix_tree_insert((ZixTree*)world->plugins, plugin, NULL);
+		lilv_uri_index_insert(world->plugins_by_uri, plugin);
 	}
 
 
@@ -473,9 +911,8 @@ lilv_world_add_plugin(LilvWorld*      world,
 	                              NULL);
 	FOREACH_MATCH(files) {
 		const SordNode* file_node = sord_iter_get_node(files, SORD_OBJECT);
-		zix_tree_insert((ZixTree*)plugin->data_uris,
-		                lilv_node_new_from_node(world, file_node),
-		                NULL);
+		lilv_array_insert((LilvArray*)plugin->data_uris,
+		                  lilv_node_new_from_node(world, file_node));
 	}
 	sord_iter_free(files);
 }
@@ -641,84 +1078,192 @@ lilv_world_get_manifest_uri(LilvWorld* world, const LilvNode* bundle_uri)
 	return manifest;
 }
 
+/** Load the data files of `plugins` in a bundle into a new model. */
 static SordModel*
-load_plugin_model(LilvWorld*      world,
-                  const LilvNode* bundle_uri,
-                  const LilvNode* plugin_uri)
+load_plugins_model(LilvWorld*       world,
+                   const LilvNode*  bundle_uri,
+                   const LilvNodes* plugins)
 {
 	// Create model and reader for loading into it
 	SordNode*   bundle_node = bundle_uri->node;
 	SordModel*  model       = sord_new(world->world, SORD_SPO|SORD_OPS, false);
 	SerdEnv*    env         = serd_env_new(sord_node_to_serd_node(bundle_node));
 	SerdReader* reader      = sord_new_reader(model, env, SERD_TURTLE, NULL);
+	ZixTree*    files       = zix_tree_new(
+		false, lilv_resource_node_cmp, NULL, (ZixDestroyFunc)lilv_node_free);
 
-	// Load manifest
-	LilvNode* manifest_uri = lilv_world_get_manifest_uri(world, bundle_uri);
-	serd_reader_add_blank_prefix(reader, lilv_world_blank_node_prefix(world));
-	serd_reader_read_file(
-		reader, (const uint8_t*)lilv_node_as_string(manifest_uri));
-
-	// Load any seeAlso files
-	SordModel* files = lilv_world_filter_model(
-		world, model, plugin_uri->node, world->uris.rdfs_seeAlso, NULL, NULL);
+	// Load any seeAlso files given in the manifest, once each
+	LILV_FOREACH(nodes, i, plugins) {
+		const LilvNode* plugin = lilv_nodes_get(plugins, i);
+		SordIter*       f      = sord_search(world->model,
+		                                     plugin->node,
+		                                     world->uris.rdfs_seeAlso,
+		                                     NULL,
+		                                     bundle_node);
+		FOREACH_MATCH(f) {
+			const SordNode* file = sord_iter_get_node(f, SORD_OBJECT);
+			if (sord_node_get_type(file) != SORD_URI) {
+				continue;
+			}
+
+			LilvNode* file_uri = lilv_node_new_from_node(world, file);
+			if (zix_tree_insert(files, file_uri, NULL)) {
+				lilv_node_free(file_uri);  // Already loaded
+				continue;
+			}
 
-	SordIter* f = sord_begin(files);
-	FOREACH_MATCH(f) {
-		const SordNode* file      = sord_iter_get_node(f, SORD_OBJECT);
-		const uint8_t*  file_str  = sord_node_get_string(file);
-		if (sord_node_get_type(file) == SORD_URI) {
 			serd_reader_add_blank_prefix(
 				reader, lilv_world_blank_node_prefix(world));
-			serd_reader_read_file(reader, file_str);
+			lilv_reader_read_file(reader, sord_node_get_string(file));
 		}
+		sord_iter_free(f);
 	}
 
-	sord_iter_free(f);
-	sord_free(files);
+	zix_tree_free(files);
 	serd_reader_free(reader);
 	serd_env_free(env);
-	lilv_node_free(manifest_uri);
 
 	return model;
 }
 
-static LilvVersion
-get_version(LilvWorld* world, SordModel* model, const LilvNode* subject)
+/** Get the version of `plugin` in `graph`, return true iff it is given. */
+static bool
+get_version(LilvWorld*      world,
+            SordModel*      model,
+            const SordNode* graph,
+            const SordNode* plugin,
+            LilvVersion*    version)
+{
+	SordNode* minor_node = sord_get(
+		model, plugin, world->uris.lv2_minorVersion, NULL, graph);
+	SordNode* micro_node = sord_get(
+		model, plugin, world->uris.lv2_microVersion, NULL, graph);
+
+	const bool found = minor_node && micro_node;
+	if (found) {
+		version->minor = atoi((const char*)sord_node_get_string(minor_node));
+		version->micro = atoi((const char*)sord_node_get_string(micro_node));
+	}
+
+	sord_node_free(world->world, micro_node);
+	sord_node_free(world->world, minor_node);
+	return found;
+}
+
+static int
+lilv_plugin_version_cmp(const void* a, const void* b)
+{
+	const SordNode* an = ((const LilvPluginVersion*)a)->plugin->node;
+	const SordNode* bn = ((const LilvPluginVersion*)b)->plugin->node;
+	return (an < bn) ? -1 : (an > bn) ? 1 : 0;
+}
+
+/**
+   Return the versions of all plugins in a loaded bundle.
+
+   Versions are taken from the manifest where possible, which is already in
+   the model.  Data files are only read for plugins whose version is not in
+   the manifest, and then only once for the whole bundle.  The table is
+   cached until the bundle is unloaded.
+*/
+static const LilvVersionTable*
+lilv_world_get_version_table(LilvWorld* world, const LilvNode* bundle_uri)
 {
-	const SordNode* minor_node = sord_get(
-		model, subject->node, world->uris.lv2_minorVersion, NULL, NULL);
-	const SordNode* micro_node = sord_get(
-		model, subject->node, world->uris.lv2_microVersion, NULL, NULL);
+	LilvVersionTable key;
+	ZixTreeIter*     t = NULL;
+	key.bundle = (LilvNode*)bundle_uri;
+	if (!zix_tree_find(world->versions, &key, &t)) {
+		return (const LilvVersionTable*)zix_tree_get(t);
+	}
 
+	LilvVersionTable* table = (LilvVersionTable*)calloc(
+		1, sizeof(LilvVersionTable));
+	table->bundle = lilv_node_duplicate(bundle_uri);
 
-	LilvVersion version = { 0, 0 };
-	if (minor_node && micro_node) {
-		version.minor = atoi((const char*)sord_node_get_string(minor_node));
-		version.micro = atoi((const char*)sord_node_get_string(micro_node));
+	// ?plugin a lv2:Plugin
+	LilvNodes* missing = lilv_nodes_new();
+	SordIter*  p       = sord_search(world->model,
+	                                 NULL,
+	                                 world->uris.rdf_a,
+	                                 world->uris.lv2_Plugin,
+	                                 bundle_uri->node);
+	FOREACH_MATCH(p) {
+		const SordNode* plug = sord_iter_get_node(p, SORD_SUBJECT);
+
+		table->plugins = (LilvPluginVersion*)realloc(
+			table->plugins,
+			(table->n_plugins + 1) * sizeof(LilvPluginVersion));
+
+		LilvPluginVersion* entry = &table->plugins[table->n_plugins++];
+		entry->plugin        = lilv_node_new_from_node(world, plug);
+		entry->version.minor = 0;
+		entry->version.micro = 0;
+		if (!get_version(world, world->model, bundle_uri->node, plug,
+		                 &entry->version)) {
+			lilv_array_insert((LilvArray*)missing,
+			                  lilv_node_duplicate(entry->plugin));
+		}
 	}
+	sord_iter_free(p);
+
+	// Get any versions not in the manifest from the plugin data files
+	if (lilv_nodes_size(missing) > 0) {
+		SordModel* model = load_plugins_model(world, bundle_uri, missing);
+		for (size_t i = 0; i < table->n_plugins; ++i) {
+			LilvPluginVersion* entry = &table->plugins[i];
+			if (lilv_nodes_contains(missing, entry->plugin)) {
+				get_version(world, model, NULL, entry->plugin->node,
+				            &entry->version);
+			}
+		}
+		sord_free(model);
+	}
+	lilv_nodes_free(missing);
 
-	return version;
+	qsort(table->plugins, table->n_plugins, sizeof(LilvPluginVersion),
+	      lilv_plugin_version_cmp);
+
+	zix_tree_insert(world->versions, table, NULL);
+	return table;
 }
 
-LILV_API void
-lilv_world_load_bundle(LilvWorld* world, const LilvNode* bundle_uri)
+/** Return the version of a plugin in a loaded bundle. */
+LilvVersion
+lilv_world_get_version(LilvWorld*      world,
+                       const LilvNode* bundle_uri,
+                       const LilvNode* plugin_uri)
 {
-	if (!lilv_node_is_uri(bundle_uri)) {
-		LILV_ERRORF("Bundle URI `%s' is not a URI\n",
-		            sord_node_get_string(bundle_uri->node));
-		return;
+	const LilvVersionTable*  table = lilv_world_get_version_table(world,
+	                                                              bundle_uri);
+	LilvPluginVersion        key;
+	const LilvPluginVersion* entry = NULL;
+
+	key.plugin = (LilvNode*)plugin_uri;
+	entry      = (const LilvPluginVersion*)bsearch(&key,
+	                                               table->plugins,
+	                                               table->n_plugins,
+	                                               sizeof(LilvPluginVersion),
+	                                               lilv_plugin_version_cmp);
+	if (entry) {
+		return entry->version;
 	}
 
+	const LilvVersion none = { 0, 0 };
+	return none;
+}
+
+/**
+   Add the plugins and specifications of a bundle whose manifest has been read
+   into the model (with graph = bundle_uri).
+*/
+static void
+lilv_world_add_bundle(LilvWorld*      world,
+                      const LilvNode* bundle_uri,
+                      const LilvNode* manifest)
+{
 	SordNode* bundle_node = bundle_uri->node;
-	LilvNode* manifest    = lilv_world_get_manifest_uri(world, bundle_uri);
 
-	// Read manifest into model with graph = bundle_node
-	SerdStatus st = lilv_world_load_graph(world, bundle_node, manifest);
-	if (st > SERD_FAILURE) {
-		LILV_ERRORF("Error reading %s\n", lilv_node_as_string(manifest));
-		lilv_node_free(manifest);
-		return;
-	}
+	++world->revision;
 
 	// ?plugin a lv2:Plugin
 	SordIter* plug_results = sord_search(world->model,
@@ -742,17 +1287,14 @@ lilv_world_load_bundle(LilvWorld* world, const LilvNode* bundle_uri)
 		}
 
 		// Compare versions
-		SordModel*  this_model   = load_plugin_model(world, bundle_uri, plugin_uri);
-		LilvVersion this_version = get_version(world, this_model, plugin_uri);
-		SordModel*  last_model   = load_plugin_model(world, last_bundle, plugin_uri);
-		LilvVersion last_version = get_version(world, last_model, plugin_uri);
-		sord_free(this_model);
-		sord_free(last_model);
+		const LilvVersion this_version = lilv_world_get_version(
+			world, bundle_uri, plugin_uri);
+		const LilvVersion last_version = lilv_world_get_version(
+			world, last_bundle, plugin_uri);
 		const int cmp = lilv_version_cmp(&this_version, &last_version);
 		if (cmp > 0) {
-			zix_tree_insert((ZixTree*)unload_uris,
-			                lilv_node_duplicate(plugin_uri),
-			                NULL);
+			lilv_array_insert((LilvArray*)unload_uris,
+			                  lilv_node_duplicate(plugin_uri));
 			LILV_WARNF("Replacing version %d.%d of <%s> from <%s>\n",
 			           last_version.minor, last_version.micro,
 			           sord_node_get_string(plug),
@@ -769,7 +1311,6 @@ lilv_world_load_bundle(LilvWorld* world, const LilvNode* bundle_uri)
 			lilv_node_free(plugin_uri);
 			sord_iter_free(plug_results);
 			lilv_world_drop_graph(world, bundle_node);
-			lilv_node_free(manifest);
 			lilv_nodes_free(unload_uris);
 			return;
 		}
@@ -787,9 +1328,8 @@ lilv_world_load_bundle(LilvWorld* world, const LilvNode* bundle_uri)
 
 		// Unload plugin and record bundle for later unloading
 		lilv_world_unload_resource(world, uri);
-		zix_tree_insert((ZixTree*)unload_bundles,
-		                lilv_node_duplicate(bundle),
-		                NULL);
+		lilv_array_insert((LilvArray*)unload_bundles,
+		                  lilv_node_duplicate(bundle));
 
 	}
 	lilv_nodes_free(unload_uris);
@@ -830,66 +1370,158 @@ lilv_world_load_bundle(LilvWorld* world, const LilvNode* bundle_uri)
 		}
 		sord_iter_free(i);
 	}
+}
 
-	lilv_node_free(manifest);
+/** Start tracking the files loaded from inside a bundle. */
+static void
+lilv_world_add_bundle_files(LilvWorld* world, const LilvNode* bundle_uri)
+{
+	LilvBundleFiles key  = { (char*)lilv_node_as_string(bundle_uri), NULL };
+	ZixTreeIter*    iter = NULL;
+	if (zix_tree_find(world->bundle_files, &key, &iter)) {
+		LilvBundleFiles* files = (LilvBundleFiles*)malloc(
+			sizeof(LilvBundleFiles));
+		files->uri   = lilv_strdup(key.uri);
+		files->files = zix_tree_new(false,
+		                            lilv_resource_node_cmp,
+		                            NULL,
+		                            (ZixDestroyFunc)lilv_node_free);
+		zix_tree_insert(world->bundle_files, files, NULL);
+	}
 }
 
-static int
-lilv_world_drop_graph(LilvWorld* world, const SordNode* graph)
+/** Return the files of the tracked bundle that contains `file`, or NULL. */
+static LilvBundleFiles*
+lilv_world_find_bundle_files(LilvWorld* world, const LilvNode* file)
 {
-	SordIter* i = sord_search(world->model, NULL, NULL, NULL, graph);
-	while (!sord_iter_end(i)) {
-		const SerdStatus st = sord_erase(world->model, i);
-		if (st) {
-			LILV_ERRORF("Error removing statement from <%s> (%s)\n",
-			            sord_node_get_string(graph), serd_strerror(st));
-			return st;
+	char*            uri    = lilv_strdup(lilv_node_as_string(file));
+	LilvBundleFiles  key    = { uri, NULL };
+	LilvBundleFiles* result = NULL;
+
+	// Look up each parent directory, from the innermost outwards
+	for (char* s = strrchr(uri, '/'); s && !result; s = strrchr(uri, '/')) {
+		ZixTreeIter* iter = NULL;
+		s[1] = '\0';
+		if (!zix_tree_find(world->bundle_files, &key, &iter)) {
+			result = (LilvBundleFiles*)zix_tree_get(iter);
 		}
+		s[0] = '\0';
 	}
-	sord_iter_free(i);
 
-	return 0;
+	free(uri);
+	return result;
 }
 
-/** Remove loaded_files entry so file will be reloaded if requested. */
-static int
-lilv_world_unload_file(LilvWorld* world, const LilvNode* file)
+/** Record that a file has been loaded, and which bundle it belongs to. */
+static void
+lilv_world_add_loaded_file(LilvWorld* world, const LilvNode* file)
 {
-	ZixTreeIter* iter;
-	if (!zix_tree_find((ZixTree*)world->loaded_files, file, &iter)) {
-		zix_tree_remove((ZixTree*)world->loaded_files, iter);
-		return 0;
+	LilvBundleFiles* owner = lilv_world_find_bundle_files(world, file);
+	if (owner) {
+		zix_tree_insert((ZixTree*)owner->files,
+		                lilv_node_duplicate(file),
+		                NULL);
 	}
-	return 1;
+
+	zix_tree_insert((ZixTree*)world->loaded_files,
+	                lilv_node_duplicate(file),
+	                NULL);
 }
 
-LILV_API int
-lilv_world_unload_bundle(LilvWorld* world, const LilvNode* bundle_uri)
+LILV_API void
+lilv_world_load_bundle(LilvWorld* world, const LilvNode* bundle_uri)
 {
-	if (!bundle_uri) {
-		return 0;
-	}
+	if (!lilv_node_is_uri(bundle_uri)) {
+		LILV_ERRORF("Bundle URI `%s' is not a URI\n",
+		            sord_node_get_string(bundle_uri->node));
+		return;
+	}
+
+	SordNode* bundle_node = bundle_uri->node;
+	LilvNode* manifest    = lilv_world_get_manifest_uri(world, bundle_uri);
+
+	lilv_world_add_bundle_files(world, bundle_uri);
+
+	// Read manifest into model with graph = bundle_node
+	SerdStatus st = lilv_world_load_graph(world, bundle_node, manifest);
+	if (st > SERD_FAILURE) {
+		LILV_ERRORF("Error reading %s\n", lilv_node_as_string(manifest));
+		lilv_node_free(manifest);
+		return;
+	}
+
+	lilv_world_add_bundle(world, bundle_uri, manifest);
+	lilv_node_free(manifest);
+}
+
+static int
+lilv_world_drop_graph(LilvWorld* world, const SordNode* graph)
+{
+	++world->revision;
 
-	// Find all loaded files that are inside the bundle
-	LilvNodes* files = lilv_nodes_new();
-	LILV_FOREACH(nodes, i, world->loaded_files) {
-		const LilvNode* file = lilv_nodes_get(world->loaded_files, i);
-		if (!strncmp(lilv_node_as_string(file),
-		             lilv_node_as_string(bundle_uri),
-		             strlen(lilv_node_as_string(bundle_uri)))) {
-			zix_tree_insert((ZixTree*)files,
-			                lilv_node_duplicate(file),
-			                NULL);
+	SordIter* i = sord_search(world->model, NULL, NULL, NULL, graph);
+	while (!sord_iter_end(i)) {
+		const SerdStatus st = sord_erase(world->model, i);
+		if (st) {
+			LILV_ERRORF("Error removing statement from <%s> (%s)\n",
+			            sord_node_get_string(graph), serd_strerror(st));
+			sord_iter_free(i);
+			return st;
 		}
 	}
+	sord_iter_free(i);
+
+	return 0;
+}
 
-	// Unload all loaded files in the bundle
-	LILV_FOREACH(nodes, i, files) {
-		const LilvNode* file = lilv_nodes_get(world->plugins, i);
-		lilv_world_unload_file(world, file);
+/** Remove loaded_files entry so file will be reloaded if requested. */
+static int
+lilv_world_unload_file(LilvWorld* world, const LilvNode* file)
+{
+	LilvBundleFiles* owner = lilv_world_find_bundle_files(world, file);
+	ZixTreeIter*     iter;
+	if (owner && !zix_tree_find((ZixTree*)owner->files, file, &iter)) {
+		zix_tree_remove((ZixTree*)owner->files, iter);
 	}
 
-	lilv_nodes_free(files);
+	if (!zix_tree_find((ZixTree*)world->loaded_files, file, &iter)) {
+		zix_tree_remove((ZixTree*)world->loaded_files, iter);
+		return 0;
+	}
+	return 1;
+}
+
+LILV_API int
+lilv_world_unload_bundle(LilvWorld* world, const LilvNode* bundle_uri)
+{
+	if (!bundle_uri) {
+		return 0;
+	}
+
+	/* Unload all loaded files in the bundle and forget about them.  Files
+	   loaded by lilv_world_load_resource() are in their own graph, plugin
+	   data files are in the bundle graph which is dropped below. */
+	int             st        = 0;
+	LilvBundleFiles files_key = { (char*)lilv_node_as_string(bundle_uri),
+	                              NULL };
+	ZixTreeIter*    owner     = NULL;
+	if (!zix_tree_find(world->bundle_files, &files_key, &owner)) {
+		const LilvBundleFiles* bundle_files =
+			(const LilvBundleFiles*)zix_tree_get(owner);
+		for (ZixTreeIter* i = zix_tree_begin(bundle_files->files);
+		     i != zix_tree_end(bundle_files->files);
+		     i = zix_tree_iter_next(i)) {
+			ZixTreeIter*    iter = NULL;
+			const LilvNode* file = (const LilvNode*)zix_tree_get(i);
+			if (lilv_world_drop_graph(world, file->node)) {
+				st = 1;
+			}
+			if (!zix_tree_find((ZixTree*)world->loaded_files, file, &iter)) {
+				zix_tree_remove((ZixTree*)world->loaded_files, iter);
+			}
+		}
+		zix_tree_remove(world->bundle_files, owner);
+	}
 
 	/* Remove any plugins in the bundle from the plugin list.  Since the
 	   application may still have a pointer to the LilvPlugin, it can not be
@@ -904,45 +1536,341 @@ lilv_world_unload_bundle(LilvWorld* world, const LilvNode* bundle_uri)
 
 		if (lilv_node_equals(lilv_plugin_get_bundle_uri(p), bundle_uri)) {
 			zix_tree_remove((ZixTree*)world->plugins, i);
+			lilv_uri_index_remove(world->plugins_by_uri, p);
 			zix_tree_insert((ZixTree*)world->zombies, p, NULL);
+			lilv_uri_index_insert(world->zombies_by_uri, p);
 		}
 
 		i = next;
 	}
 
+	// Forget cached plugin versions, since the bundle may change
+	LilvVersionTable key;
+	ZixTreeIter*     v = NULL;
+	key.bundle = (LilvNode*)bundle_uri;
+	if (!zix_tree_find(world->versions, &key, &v)) {
+		zix_tree_remove(world->versions, v);
+	}
+
+	// Remove any specifications in the bundle
+	for (LilvSpec** s = &world->specs; *s;) {
+		LilvSpec* const spec = *s;
+		if (sord_node_equals(spec->bundle, bundle_uri->node)) {
+			*s = spec->next;
+			if (!spec->loaded) {
+				lilv_world_remove_lazy_spec(world, spec);
+			}
+			lilv_spec_free(world, spec);
+		} else {
+			s = &spec->next;
+		}
+	}
+
 	// Drop everything in bundle graph
-	return lilv_world_drop_graph(world, bundle_uri->node);
+	return lilv_world_drop_graph(world, bundle_uri->node) || st;
+}
+
+static int
+lilv_bundle_record_cmp(const void* a, const void* b)
+{
+	return strcmp(lilv_node_as_uri(((const LilvBundleRecord*)a)->uri),
+	              lilv_node_as_uri(((const LilvBundleRecord*)b)->uri));
+}
+
+/** Return the record of a bundle previously found in LV2_PATH, or NULL. */
+static LilvBundleRecord*
+lilv_world_find_bundle_record(LilvWorld* world, const LilvNode* bundle_uri)
+{
+	LilvBundleRecord key;
+	key.uri = (LilvNode*)bundle_uri;
+	return (LilvBundleRecord*)bsearch(&key,
+	                                  world->bundles,
+	                                  world->n_bundles,
+	                                  sizeof(LilvBundleRecord),
+	                                  lilv_bundle_record_cmp);
+}
+
+/** Bundles found in LV2_PATH, in discovery order. */
+typedef struct {
+	LilvWorld* world;
+	LilvNode** uris;
+	size_t     n_uris;
+} LilvBundleList;
+
+/** Return the URI of the bundle at `path`, which has a trailing slash. */
+static LilvNode*
+lilv_new_bundle_uri(LilvWorld* world, const char* path)
+{
+	SerdNode  suri = serd_node_new_file_uri((const uint8_t*)path, 0, 0, true);
+	LilvNode* node = lilv_new_uri(world, (const char*)suri.buf);
+	serd_node_free(&suri);
+	return node;
 }
 
 static void
 load_dir_entry(const char* dir, const char* name, void* data)
 {
-	LilvWorld* world = (LilvWorld*)data;
+	LilvBundleList* list = (LilvBundleList*)data;
 	if (!strcmp(name, ".") || !strcmp(name, "..")) {
 		return;
 	}
 
-	char*     path = lilv_strjoin(dir, "/", name, "/", NULL);
-	SerdNode  suri = serd_node_new_file_uri((const uint8_t*)path, 0, 0, true);
-	LilvNode* node = lilv_new_uri(world, (const char*)suri.buf);
+	char* path = lilv_strjoin(dir, "/", name, "/", NULL);
+
+	list->uris = (LilvNode**)realloc(
+		list->uris, (list->n_uris + 1) * sizeof(LilvNode*));
+	list->uris[list->n_uris++] = lilv_new_bundle_uri(list->world, path);
 
-	lilv_world_load_bundle(world, node);
-	lilv_node_free(node);
-	serd_node_free(&suri);
 	free(path);
 }
 
-/** Load all bundles in the directory at `dir_path`. */
+/** Find all bundles in the directory at `dir_path`. */
 static void
-lilv_world_load_directory(LilvWorld* world, const char* dir_path)
+lilv_world_find_bundles(LilvBundleList* list, const char* dir_path)
 {
 	char* path = lilv_expand(dir_path);
 	if (path) {
-		lilv_dir_for_each(path, world, load_dir_entry);
+		lilv_dir_for_each(path, list, load_dir_entry);
 		free(path);
 	}
 }
 
+/** Return SERD_FAILURE if `uri` is not a local Turtle file that is unloaded. */
+static SerdStatus
+lilv_world_check_file(LilvWorld* world, const LilvNode* uri)
+{
+	ZixTreeIter* iter;
+	if (!zix_tree_find((ZixTree*)world->loaded_files, uri, &iter)) {
+		return SERD_FAILURE;  // File has already been loaded
+	}
+
+	size_t               uri_len;
+	const uint8_t* const uri_str = sord_node_get_string_counted(
+		uri->node, &uri_len);
+	if (strncmp((const char*)uri_str, "file:", 5)) {
+		return SERD_FAILURE;  // Not a local file
+	} else if (strcmp((const char*)uri_str + uri_len - 4, ".ttl")) {
+		return SERD_FAILURE;  // Not a Turtle file
+	}
+
+	return SERD_SUCCESS;
+}
+
+/** Merge a parsed file into the model, like lilv_world_load_file(). */
+static SerdStatus
+lilv_world_load_parsed(LilvWorld*          world,
+                       const LilvParseJob* job,
+                       const SordNode*     graph)
+{
+	lilv_parse_job_merge(job, world->world, world->model, graph);
+	if (job->status) {
+		LILV_ERRORF("Error loading file `%s'\n", lilv_node_as_string(job->uri));
+		return job->status;
+	}
+
+	lilv_world_add_loaded_file(world, job->uri);
+	return SERD_SUCCESS;
+}
+
+/** State of a bundle being loaded by lilv_world_load_bundles(). */
+typedef struct {
+	LilvNode*             manifest;  ///< Manifest URI
+	LilvBundleStamp       stamp;     ///< File system state
+	bool                  stamped;   ///< True iff stamp is valid
+	bool                  loaded;    ///< True iff the manifest was loaded
+	const LilvIndexEntry* entry;     ///< Up to date index entry, or NULL
+} LilvBundleLoad;
+
+/**
+   Record the state of loaded bundles for lilv_world_rescan().
+
+   Stamps are only recorded if they include data files, otherwise the time
+   when loading started is used to detect changes.
+*/
+static void
+lilv_world_record_bundles(LilvWorld*            world,
+                          LilvNode**            bundles,
+                          const LilvBundleLoad* loads,
+                          size_t                n_bundles,
+                          bool                  data,
+                          int64_t               start_time)
+{
+	const size_t n_old = world->n_bundles;
+	size_t       n_new = 0;
+
+	LilvBundleRecord* records = (LilvBundleRecord*)realloc(
+		world->bundles, (n_old + n_bundles) * sizeof(LilvBundleRecord));
+
+	world->bundles = records;
+	for (size_t i = 0; i < n_bundles; ++i) {
+		LilvBundleRecord* record = lilv_world_find_bundle_record(world,
+		                                                         bundles[i]);
+		if (!record) {
+			record      = &records[n_old + n_new++];
+			record->uri = lilv_node_duplicate(bundles[i]);
+		}
+		record->stamp   = loads[i].stamp;
+		record->time    = start_time;
+		record->stamped = data && loads[i].stamped;
+		record->loaded  = loads[i].loaded;
+	}
+
+	world->n_bundles = n_old + n_new;
+	qsort(records, world->n_bundles, sizeof(LilvBundleRecord),
+	      lilv_bundle_record_cmp);
+}
+
+/**
+   Load the bundles found in LV2_PATH.
+
+   Manifests of bundles that have not changed since the discovery index was
+   written are replayed from the index.  Others are parsed, in parallel if
+   several discovery threads are enabled.  Either way, the results are merged
+   into the model and bundles are added by the calling thread in discovery
+   order, so duplicates, replacements, and version conflicts are resolved
+   exactly as if each bundle was loaded with lilv_world_load_bundle().
+
+   Bundles are only stamped if there is an index, or if `data` is true, in
+   which case the stamp includes every file in the bundle for rescanning.
+*/
+static void
+lilv_world_load_bundles(LilvWorld* world,
+                        LilvNode** bundles,
+                        size_t     n_bundles,
+                        bool       data)
+{
+	const int64_t     start_time = lilv_current_time();
+	const char* const index_path = world->opt.index_path;
+	const bool        stamp      = data || index_path;
+	const bool        threaded   = (world->opt.discovery_threads > 1 &&
+	                                n_bundles > 1);
+
+	LilvIndex* index     = index_path ? lilv_index_read(index_path) : NULL;
+	LilvIndex* new_index = index_path ? lilv_index_new() : NULL;
+	size_t     n_reused  = 0;
+	bool*      loading   = (index
+	                        ? (bool*)calloc(index->n_entries, sizeof(bool))
+	                        : NULL);
+
+	LilvBundleLoad* loads = (LilvBundleLoad*)calloc(n_bundles,
+	                                                sizeof(LilvBundleLoad));
+	LilvParseJob*   jobs  = threaded
+		? (LilvParseJob*)calloc(n_bundles, sizeof(LilvParseJob))
+		: NULL;
+
+	// Find up to date index entries and prepare parse jobs for everything else
+	for (size_t i = 0; i < n_bundles; ++i) {
+		LilvBundleLoad* load = &loads[i];
+		const char* uri  = lilv_node_as_uri(bundles[i]);
+		char*       path = lilv_file_uri_parse(uri, NULL);
+		load->manifest = lilv_world_get_manifest_uri(world, bundles[i]);
+		lilv_world_add_bundle_files(world, bundles[i]);
+		const LilvIndexEntry* entry = index ? lilv_index_find(index, uri) : NULL;
+		if (entry) {
+			loading[entry - index->entries] = true;
+		}
+
+		if (stamp && path && !lilv_bundle_stamp(path, data, &load->stamp)) {
+			load->stamped = true;
+			if (entry && lilv_bundle_manifest_stamp_equals(&entry->stamp,
+			                                               &load->stamp)) {
+				load->entry = entry;
+			}
+		}
+		lilv_free(path);
+
+		if (jobs && !load->entry &&
+		    !lilv_world_check_file(world, load->manifest)) {
+			lilv_parse_job_init(&jobs[i],
+			                    load->manifest,
+			                    lilv_world_blank_node_prefix(world));
+		}
+	}
+
+	if (jobs) {
+		lilv_parse_jobs_run(jobs, n_bundles, world->opt.discovery_threads);
+	}
+
+	for (size_t i = 0; i < n_bundles; ++i) {
+		LilvBundleLoad* load        = &loads[i];
+		SordNode*       bundle_node = bundles[i]->node;
+		SerdStatus      st          = SERD_FAILURE;
+		if (!lilv_world_check_file(world, load->manifest)) {
+			if (load->entry &&
+			    lilv_index_replay(world, load->entry, bundle_node)) {
+				lilv_world_add_loaded_file(world, load->manifest);
+				st = SERD_SUCCESS;
+			} else if (jobs && jobs[i].world) {
+				load->entry = NULL;
+				st = lilv_world_load_parsed(world, &jobs[i], bundle_node);
+			} else {
+				// Not parsed in advance, or unloaded since, so read it now
+				load->entry = NULL;
+				st = lilv_world_load_graph(world, bundle_node, load->manifest);
+			}
+		}
+
+		// Record manifest statements in new index before anything is dropped
+		if (new_index && load->stamped) {
+			const char* uri = lilv_node_as_uri(bundles[i]);
+			if (load->entry) {
+				lilv_index_add(new_index, uri, &load->stamp,
+				               load->entry->data, load->entry->len);
+				++n_reused;
+			} else if (!st) {
+				size_t len  = 0;
+				char*  data = lilv_index_encode_graph(world, bundle_node, &len);
+				lilv_index_add(new_index, uri, &load->stamp, data, len);
+				free(data);
+			}
+		}
+
+		if (st > SERD_FAILURE) {
+			LILV_ERRORF("Error reading %s\n",
+			            lilv_node_as_string(load->manifest));
+		} else {
+			load->loaded = true;
+			lilv_world_add_bundle(world, bundles[i], load->manifest);
+		}
+
+		if (jobs) {
+			lilv_parse_job_clear(&jobs[i]);
+		}
+		lilv_node_free(load->manifest);
+	}
+
+	lilv_world_record_bundles(world, bundles, loads, n_bundles, data, start_time);
+
+	/* Keep the entries of other bundles that are still loaded, so loading a
+	   few changed bundles does not drop everything else from the index.
+	   Entries are checked when they are used, so they are copied as is. */
+	for (size_t i = 0; new_index && index && i < index->n_entries; ++i) {
+		const LilvIndexEntry* entry = &index->entries[i];
+		if (!loading[i]) {
+			LilvNode* uri = lilv_new_uri(world, entry->uri);
+			if (lilv_world_find_bundle_record(world, uri)) {
+				lilv_index_add(new_index, entry->uri, &entry->stamp,
+				               entry->data, entry->len);
+				++n_reused;
+			}
+			lilv_node_free(uri);
+		}
+	}
+
+	// Write index if anything changed
+	if (new_index && (!index ||
+	                  n_reused != new_index->n_entries ||
+	                  n_reused != index->n_entries)) {
+		lilv_index_write(new_index, index_path);
+	}
+
+	lilv_index_free(new_index);
+	lilv_index_free(index);
+	free(loading);
+	free(jobs);
+	free(loads);
+}
+
 static const char*
 first_path_sep(const char* path)
 {
@@ -954,14 +1882,15 @@ first_path_sep(const char* path)
 	return NULL;
 }
 
-/** Load all bundles found in `lv2_path`.
+/** Call `func` for every directory in `lv2_path`.
  * @param lv2_path A colon-delimited list of directories.  These directories
  * should contain LV2 bundle directories (ie the search path is a list of
  * parent directories of bundles, not a list of bundle directories).
  */
 static void
-lilv_world_load_path(LilvWorld*  world,
-                     const char* lv2_path)
+lilv_for_each_path_dir(const char* lv2_path,
+                       void*       data,
+                       void (*func)(const char* dir, void* data))
 {
 	while (lv2_path[0] != '\0') {
 		const char* const sep = first_path_sep(lv2_path);
@@ -970,23 +1899,207 @@ lilv_world_load_path(LilvWorld*  world,
 			char* const  dir     = (char*)malloc(dir_len + 1);
 			memcpy(dir, lv2_path, dir_len);
 			dir[dir_len] = '\0';
-			lilv_world_load_directory(world, dir);
+			func(dir, data);
 			free(dir);
 			lv2_path += dir_len + 1;
 		} else {
-			lilv_world_load_directory(world, lv2_path);
+			func(lv2_path, data);
 			lv2_path = "\0";
 		}
 	}
 }
 
+static void
+find_dir_bundles(const char* dir, void* data)
+{
+	lilv_world_find_bundles((LilvBundleList*)data, dir);
+}
+
+/** Find all bundles in `lv2_path`. */
+static void
+lilv_world_find_path_bundles(LilvBundleList* list, const char* lv2_path)
+{
+	lilv_for_each_path_dir(lv2_path, list, find_dir_bundles);
+}
+
+static void
+lilv_bundle_list_clear(LilvBundleList* list)
+{
+	for (size_t i = 0; i < list->n_uris; ++i) {
+		lilv_node_free(list->uris[i]);
+	}
+	free(list->uris);
+	list->uris   = NULL;
+	list->n_uris = 0;
+}
+
+/** Load all bundles found in `lv2_path`. */
+static void
+lilv_world_load_path(LilvWorld*  world,
+                     const char* lv2_path)
+{
+	LilvBundleList list = { world, NULL, 0 };
+	lilv_world_find_path_bundles(&list, lv2_path);
+	lilv_world_load_bundles(world, list.uris, list.n_uris, false);
+	lilv_bundle_list_clear(&list);
+}
+
+/** Load the data files of `spec` if they have not been loaded already. */
+static void
+lilv_world_load_spec(LilvWorld* world, LilvSpec* spec)
+{
+	if (!spec->loaded) {
+		lilv_world_remove_lazy_spec(world, spec);
+		spec->loaded = true;
+		LILV_FOREACH(nodes, f, spec->data_uris) {
+			const LilvNode* file = lilv_nodes_get(spec->data_uris, f);
+			lilv_world_load_graph(world, NULL, file);
+		}
+	}
+}
+
+/** Load any unloaded specifications with the URI `uri` of length `len`. */
+static void
+lilv_world_load_lazy_specs(LilvWorld* world, const char* uri, size_t len)
+{
+	const LilvLazySpecs  key   = { (char*)uri, len, NULL };
+	const LilvLazySpecs* entry = NULL;
+	while ((entry = (const LilvLazySpecs*)zix_hash_find(world->lazy_specs,
+	                                                    &key))) {
+		lilv_world_load_spec(world, entry->specs);  // Removes it from entry
+	}
+}
+
+void
+lilv_world_load_specs_for(LilvWorld* world, const SordNode* node)
+{
+	if (!node || sord_node_get_type(node) != SORD_URI ||
+	    !zix_hash_size(world->lazy_specs)) {
+		return;
+	}
+
+	/* A specification covers the URIs it is a prefix of, if it ends with a
+	   separator or is followed by one, so only those prefixes are looked up. */
+	const char* const uri = (const char*)sord_node_get_string(node);
+	const size_t      len = strlen(uri);
+	for (size_t i = 1; i <= len && zix_hash_size(world->lazy_specs); ++i) {
+		if (i == len) {
+			lilv_world_load_lazy_specs(world, uri, len);
+		} else if (uri[i] == '#' || uri[i] == '/') {
+			lilv_world_load_lazy_specs(world, uri, i);
+			lilv_world_load_lazy_specs(world, uri, i + 1);
+		}
+	}
+}
+
 void
 lilv_world_load_specifications(LilvWorld* world)
 {
 	for (LilvSpec* spec = world->specs; spec; spec = spec->next) {
-		LILV_FOREACH(nodes, f, spec->data_uris) {
-			LilvNode* file = (LilvNode*)lilv_collection_get(spec->data_uris, f);
-			lilv_world_load_graph(world, NULL, file);
+		lilv_world_load_spec(world, spec);
+	}
+}
+
+const LilvPluginClass*
+lilv_world_find_plugin_class(const LilvWorld* world, const SordNode* uri)
+{
+	return (const LilvPluginClass*)lilv_uri_index_find(world->classes_by_uri,
+	                                                   uri);
+}
+
+/** Build the class hierarchy from the parent URIs of all plugin classes. */
+static void
+lilv_world_build_class_tree(LilvWorld* world)
+{
+	LilvPluginClass* const root = world->lv2_plugin_class;
+	const size_t           n    = lilv_plugin_classes_size(world->plugin_classes);
+
+	// Collect classes into an array for the passes below
+	free(world->all_classes);
+	world->all_classes = (LilvPluginClass**)calloc(
+		n, sizeof(LilvPluginClass*));
+	world->n_classes = 0;
+	lilv_plugin_class_clear_tree(root);
+	LILV_FOREACH(plugin_classes, i, world->plugin_classes) {
+		LilvPluginClass* c = (LilvPluginClass*)lilv_plugin_classes_get(
+			world->plugin_classes, i);
+		lilv_plugin_class_clear_tree(c);
+		world->all_classes[world->n_classes++] = c;
+	}
+
+	// Link every class to its parent
+	for (size_t i = 0; i < n; ++i) {
+		LilvPluginClass* c      = world->all_classes[i];
+		const SordNode*  parent = c->parent_uri ? c->parent_uri->node : NULL;
+		if (c->uri->node == root->uri->node) {
+			continue;  // Loaded lv2:Plugin class, an alias of the root
+		} else if (parent == root->uri->node) {
+			c->parent = root;
+		} else if (parent) {
+			c->parent = lilv_world_find_plugin_class(world, parent);
+		}
+	}
+
+	// Break any cycles, so every chain of parents ends at a root
+	for (size_t i = 0; i < n; ++i) {
+		size_t steps = 0;
+		for (LilvPluginClass* a = world->all_classes[i]; a->parent;
+		     a = (LilvPluginClass*)a->parent) {
+			if (++steps > n) {
+				a->parent = NULL;
+				break;
+			}
+		}
+	}
+
+	// Set ancestors and count children
+	for (size_t i = 0; i < n; ++i) {
+		LilvPluginClass* c = world->all_classes[i];
+		for (const LilvPluginClass* a = c->parent; a; a = a->parent) {
+			++c->depth;
+		}
+
+		c->ancestors = (const LilvPluginClass**)calloc(
+			c->depth, sizeof(LilvPluginClass*));
+		unsigned depth = c->depth;
+		for (const LilvPluginClass* a = c->parent; a; a = a->parent) {
+			c->ancestors[--depth] = a;
+		}
+
+		if (c->parent) {
+			++((LilvPluginClass*)c->parent)->n_children;
+		}
+	}
+
+	// Allocate child arrays, then fill them in URI order
+	root->children = (const LilvPluginClass**)calloc(
+		root->n_children, sizeof(LilvPluginClass*));
+	root->n_children = 0;
+	for (size_t i = 0; i < n; ++i) {
+		LilvPluginClass* c = world->all_classes[i];
+		c->children = (const LilvPluginClass**)calloc(
+			c->n_children, sizeof(LilvPluginClass*));
+		c->n_children = 0;
+	}
+	LILV_FOREACH(plugin_classes, i, world->plugin_classes) {
+		const LilvPluginClass* c = lilv_plugin_classes_get(
+			world->plugin_classes, i);
+		if (c->parent) {
+			LilvPluginClass* parent = (LilvPluginClass*)c->parent;
+			parent->children[parent->n_children++] = c;
+		}
+	}
+
+	// Give aliases of the root the same children
+	for (size_t i = 0; i < n; ++i) {
+		LilvPluginClass* c = world->all_classes[i];
+		if (c->uri->node == root->uri->node && root->n_children) {
+			c->children = (const LilvPluginClass**)realloc(
+				c->children, root->n_children * sizeof(LilvPluginClass*));
+			memcpy(c->children,
+			       root->children,
+			       root->n_children * sizeof(LilvPluginClass*));
+			c->n_children = root->n_children;
 		}
 	}
 }
@@ -1024,18 +2137,35 @@ lilv_world_load_plugin_classes(LilvWorld* world)
 		LilvPluginClass* pclass = lilv_plugin_class_new(
 			world, parent, class_node,
 			(const char*)sord_node_get_string(label));
-		if (pclass) {
-			zix_tree_insert((ZixTree*)world->plugin_classes, pclass, NULL);
+		if (pclass && zix_tree_insert((ZixTree*)world->plugin_classes,
+		                              pclass, NULL)) {
+			// Already loaded, for example before a rescan
+			lilv_plugin_class_free(pclass);
+		} else if (pclass) {
+			lilv_uri_index_insert(world->classes_by_uri, pclass);
 		}
 
 		sord_node_free(world->world, label);
 		sord_node_free(world->world, parent);
 	}
 	sord_iter_free(classes);
+
+	lilv_world_build_class_tree(world);
+	world->classes_loaded = true;
 }
 
-LILV_API void
-lilv_world_load_all(LilvWorld* world)
+void
+lilv_world_load_classes_if_necessary(LilvWorld* world)
+{
+	if (world->opt.lazy_specs && !world->classes_loaded) {
+		// Plugin classes are defined in the specification of lv2:Plugin
+		lilv_world_load_specs_for(world, world->uris.lv2_Plugin);
+		lilv_world_load_plugin_classes(world);
+	}
+}
+
+static const char*
+lilv_world_get_lv2_path(const LilvWorld* world)
 {
 	const char* lv2_path = world->opt.lv2_path;
 	if (!lv2_path) {
@@ -1044,57 +2174,411 @@ lilv_world_load_all(LilvWorld* world)
 	if (!lv2_path) {
 		lv2_path = LILV_DEFAULT_LV2_PATH;
 	}
+	return lv2_path;
+}
 
-	// Discover bundles and read all manifest files into model
-	lilv_world_load_path(world, lv2_path);
-
+/** Cache things that depend on all discovered bundles. */
+static void
+lilv_world_finish_discovery(LilvWorld* world)
+{
+	/* Mark replaced plugins.  The model has no predicate index, so rather
+	   than filtering every statement for ?new dc:replaces ?old, this looks up
+	   ?new dc:replaces <plugin> in the OPS index, which costs one logarithmic
+	   search per plugin. */
 	LILV_FOREACH(plugins, p, world->plugins) {
-		const LilvPlugin* plugin = (const LilvPlugin*)lilv_collection_get(
+		LilvPlugin* plugin = (LilvPlugin*)lilv_collection_get(
 			(ZixTree*)world->plugins, p);
 
-		// ?new dc:replaces plugin
-		if (sord_ask(world->model,
-		             NULL,
-		             world->uris.dc_replaces,
-		             lilv_plugin_get_uri(plugin)->node,
-		             NULL)) {
-			// TODO: Check if replacement is a known plugin? (expensive)
-			((LilvPlugin*)plugin)->replaced = true;
+		plugin->replaced = false;
+		lilv_node_free(plugin->replaced_by);
+		plugin->replaced_by = NULL;
+
+		SordIter* r = sord_search(world->model,
+		                          NULL,
+		                          world->uris.dc_replaces,
+		                          plugin->plugin_uri->node,
+		                          NULL);
+		FOREACH_MATCH(r) {
+			const SordNode* new_node = sord_iter_get_node(r, SORD_SUBJECT);
+
+			plugin->replaced = true;
+			if (!plugin->replaced_by &&
+			    lilv_uri_index_find(world->plugins_by_uri, new_node)) {
+				plugin->replaced_by = lilv_node_new_from_node(world, new_node);
+			}
 		}
+		sord_iter_free(r);
 	}
 
-	// Query out things to cache
-	lilv_world_load_specifications(world);
-	lilv_world_load_plugin_classes(world);
+	// Query out things to cache, unless that is deferred until needed
+	if (world->opt.lazy_specs) {
+		world->classes_loaded = false;
+	} else {
+		lilv_world_load_specifications(world);
+		lilv_world_load_plugin_classes(world);
+	}
 }
 
-SerdStatus
-lilv_world_load_file(LilvWorld* world, SerdReader* reader, const LilvNode* uri)
+LILV_API void
+lilv_world_load_all(LilvWorld* world)
 {
-	ZixTreeIter* iter;
-	if (!zix_tree_find((ZixTree*)world->loaded_files, uri, &iter)) {
-		return SERD_FAILURE;  // File has already been loaded
+	// Discover bundles and read all manifest files into model
+	lilv_world_load_path(world, lilv_world_get_lv2_path(world));
+
+	lilv_world_finish_discovery(world);
+}
+
+/** What lilv_world_update() does with a bundle. */
+typedef enum {
+	LILV_UPDATE_KEEP,    ///< Unchanged, leave it alone
+	LILV_UPDATE_ADD,     ///< New bundle, load it
+	LILV_UPDATE_RELOAD,  ///< Changed bundle, unload and load it again
+	LILV_UPDATE_REMOVE,  ///< Vanished bundle, unload it
+} LilvUpdateAction;
+
+/**
+   Return true iff a bundle has changed since it was recorded.
+
+   Bundles loaded by lilv_world_load_all() are not stamped, so that discovery
+   does not need to visit every file.  For these, anything in the bundle that
+   is newer than the time loading started counts as a change, and the current
+   stamp is recorded for the next rescan if there is none.
+*/
+static bool
+lilv_bundle_record_is_stale(LilvBundleRecord* record)
+{
+	LilvBundleStamp stamp;
+	char*           path    = lilv_file_uri_parse(
+		lilv_node_as_uri(record->uri), NULL);
+	const bool      stamped = path && !lilv_bundle_stamp(path, true, &stamp);
+
+	lilv_free(path);
+	if (!stamped) {
+		return record->loaded;  // Manifest is gone
+	} else if (record->stamped) {
+		return !lilv_bundle_stamp_equals(&stamp, &record->stamp);
+	} else if (!record->loaded ||
+	           lilv_bundle_stamp_newest(&stamp) >= record->time) {
+		return true;
 	}
 
-	size_t               uri_len;
-	const uint8_t* const uri_str = sord_node_get_string_counted(
-		uri->node, &uri_len);
-	if (strncmp((const char*)uri_str, "file:", 5)) {
-		return SERD_FAILURE;  // Not a local file
-	} else if (strcmp((const char*)uri_str + uri_len - 4, ".ttl")) {
-		return SERD_FAILURE;  // Not a Turtle file
+	record->stamp   = stamp;
+	record->stamped = true;
+	return false;
+}
+
+/** Add the URIs of plugins in `a` that are not in `b` to `result`. */
+static void
+lilv_plugins_difference(const LilvPlugins* a,
+                        const LilvPlugins* b,
+                        LilvNodes*         result)
+{
+	LILV_FOREACH(plugins, i, a) {
+		const LilvNode* uri = lilv_plugin_get_uri(lilv_plugins_get(a, i));
+		if (!lilv_plugins_get_by_uri(b, uri)) {
+			lilv_array_insert((LilvArray*)result, lilv_node_duplicate(uri));
+		}
+	}
+}
+
+/** Set `*result` to `nodes` if `result` is non-NULL, or free `nodes`. */
+static void
+lilv_nodes_return(LilvNodes* nodes, LilvNodes** result)
+{
+	if (result) {
+		*result = nodes;
+	} else {
+		lilv_nodes_free(nodes);
+	}
+}
+
+/**
+   Bring the world up to date with the current state of some bundles.
+
+   Each of `bundles` that is present on disk is loaded if it is new, or
+   reloaded if it has changed since it was recorded, or if `force` is true.
+   Each that is not present is unloaded if it was previously loaded.  Bundles
+   are loaded in the given order.
+*/
+static int
+lilv_world_update(LilvWorld*  world,
+                  LilvNode**  bundles,
+                  const bool* present,
+                  size_t      n_bundles,
+                  bool        force,
+                  LilvNodes** added,
+                  LilvNodes** removed,
+                  LilvNodes** changed)
+{
+	// Decide what to do with every bundle
+	LilvUpdateAction* actions = (LilvUpdateAction*)calloc(
+		n_bundles, sizeof(LilvUpdateAction));
+	bool*  removing  = (bool*)calloc(world->n_bundles, sizeof(bool));
+	size_t n_changes = 0;
+	for (size_t i = 0; i < n_bundles; ++i) {
+		LilvBundleRecord* record = lilv_world_find_bundle_record(world,
+		                                                         bundles[i]);
+		if (!present[i]) {
+			if (record) {
+				actions[i]                        = LILV_UPDATE_REMOVE;
+				removing[record - world->bundles] = true;
+				++n_changes;
+			}
+		} else if (!record) {
+			actions[i] = LILV_UPDATE_ADD;
+			++n_changes;
+		} else if (force || lilv_bundle_record_is_stale(record)) {
+			actions[i] = LILV_UPDATE_RELOAD;
+			++n_changes;
+		}
+	}
+
+	// Remember which plugins were loaded to summarize changes later
+	LilvPlugins* old_plugins = lilv_plugins_new();
+	LILV_FOREACH(plugins, i, world->plugins) {
+		zix_tree_insert((ZixTree*)old_plugins,
+		                (LilvPlugin*)lilv_plugins_get(world->plugins, i),
+		                NULL);
+	}
+
+	// Unload removed bundles and forget about them
+	ZixTree* touched = zix_tree_new(
+		false, lilv_resource_node_cmp, NULL, (ZixDestroyFunc)lilv_node_free);
+	int    st     = 0;
+	size_t n_kept = 0;
+	for (size_t i = 0; i < world->n_bundles; ++i) {
+		const LilvBundleRecord record = world->bundles[i];
+		if (removing[i]) {
+			st = lilv_world_unload_bundle(world, record.uri) || st;
+			zix_tree_insert(touched, record.uri, NULL);
+		} else {
+			world->bundles[n_kept++] = record;
+		}
+	}
+	world->n_bundles = n_kept;
+
+	// Unload changed bundles, and gather everything to load in order
+	LilvNode** load_uris = (LilvNode**)calloc(n_bundles + world->n_bundles,
+	                                          sizeof(LilvNode*));
+	size_t     n_load    = 0;
+	for (size_t i = 0; i < n_bundles; ++i) {
+		if (actions[i] == LILV_UPDATE_RELOAD) {
+			st = lilv_world_unload_bundle(world, bundles[i]) || st;
+		}
+		if (actions[i] == LILV_UPDATE_ADD || actions[i] == LILV_UPDATE_RELOAD) {
+			load_uris[n_load++] = bundles[i];
+			zix_tree_insert(touched, lilv_node_duplicate(bundles[i]), NULL);
+		}
+	}
+
+	if (n_changes) {
+		/* Bundles that were ignored in favour of a newer version of a plugin
+		   have no statements left in the model.  Try them again, since the
+		   newer version may have just been removed or changed. */
+		for (size_t i = 0; i < world->n_bundles; ++i) {
+			const LilvBundleRecord* record = &world->bundles[i];
+			ZixTreeIter*            t      = NULL;
+			if (record->loaded &&
+			    zix_tree_find(touched, record->uri, &t) &&
+			    !sord_ask(world->model, NULL, NULL, NULL, record->uri->node)) {
+				lilv_world_unload_bundle(world, record->uri);
+				load_uris[n_load++] = record->uri;
+				zix_tree_insert(touched,
+				                lilv_node_duplicate(record->uri),
+				                NULL);
+			}
+		}
+
+		lilv_world_load_bundles(world, load_uris, n_load, true);
+		lilv_world_finish_discovery(world);
+	}
+
+	// Summarize changes to plugins
+	LilvNodes* new_uris     = lilv_nodes_new();
+	LilvNodes* gone_uris    = lilv_nodes_new();
+	LilvNodes* changed_uris = lilv_nodes_new();
+	lilv_plugins_difference(world->plugins, old_plugins, new_uris);
+	lilv_plugins_difference(old_plugins, world->plugins, gone_uris);
+	LILV_FOREACH(plugins, i, world->plugins) {
+		const LilvPlugin* plugin = lilv_plugins_get(world->plugins, i);
+		const LilvNode*   uri    = lilv_plugin_get_uri(plugin);
+		ZixTreeIter*      t      = NULL;
+		if (lilv_plugins_get_by_uri(old_plugins, uri) &&
+		    !zix_tree_find(touched, lilv_plugin_get_bundle_uri(plugin), &t)) {
+			lilv_array_insert((LilvArray*)changed_uris,
+			                  lilv_node_duplicate(uri));
+		}
 	}
 
+	lilv_nodes_return(new_uris, added);
+	lilv_nodes_return(gone_uris, removed);
+	lilv_nodes_return(changed_uris, changed);
+
+	zix_tree_free(touched);
+	zix_tree_free((ZixTree*)old_plugins);
+	free(load_uris);
+	free(removing);
+	free(actions);
+	return st;
+}
+
+LILV_API int
+lilv_world_rescan(LilvWorld*  world,
+                  LilvNodes** added,
+                  LilvNodes** removed,
+                  LilvNodes** changed)
+{
+	LilvBundleList list = { world, NULL, 0 };
+	lilv_world_find_path_bundles(&list, lilv_world_get_lv2_path(world));
+
+	// Every bundle found is present, every other recorded bundle is not
+	const size_t n_found = list.n_uris;
+	bool*        seen    = (bool*)calloc(world->n_bundles, sizeof(bool));
+	for (size_t i = 0; i < n_found; ++i) {
+		const LilvBundleRecord* record = lilv_world_find_bundle_record(
+			world, list.uris[i]);
+		if (record) {
+			seen[record - world->bundles] = true;
+		}
+	}
+
+	for (size_t i = 0; i < world->n_bundles; ++i) {
+		if (!seen[i]) {
+			list.uris = (LilvNode**)realloc(
+				list.uris, (list.n_uris + 1) * sizeof(LilvNode*));
+			list.uris[list.n_uris++] = lilv_node_duplicate(
+				world->bundles[i].uri);
+		}
+	}
+
+	bool* present = (bool*)calloc(list.n_uris, sizeof(bool));
+	for (size_t i = 0; i < n_found; ++i) {
+		present[i] = true;
+	}
+
+	const int st = lilv_world_update(world,
+	                                 list.uris,
+	                                 present,
+	                                 list.n_uris,
+	                                 false,
+	                                 added,
+	                                 removed,
+	                                 changed);
+
+	free(present);
+	free(seen);
+	lilv_bundle_list_clear(&list);
+	return st;
+}
+
+/** Directories in LV2_PATH to watch. */
+typedef struct {
+	char** dirs;
+	size_t n_dirs;
+} LilvWatchDirs;
+
+static void
+add_watch_dir(const char* dir, void* data)
+{
+	LilvWatchDirs* dirs = (LilvWatchDirs*)data;
+	char*          path = lilv_expand(dir);
+	if (path) {
+		dirs->dirs = (char**)realloc(dirs->dirs,
+		                             (dirs->n_dirs + 1) * sizeof(char*));
+		dirs->dirs[dirs->n_dirs++] = path;
+	}
+}
+
+LILV_API int
+lilv_world_watch(LilvWorld* world)
+{
+	if (world->watcher) {
+		return 0;
+	}
+
+	LilvWatchDirs dirs = { NULL, 0 };
+	lilv_for_each_path_dir(lilv_world_get_lv2_path(world), &dirs, add_watch_dir);
+
+	world->watcher = lilv_watcher_new(dirs.dirs,
+	                                  dirs.n_dirs,
+	                                  LILV_WATCH_QUIET_PERIOD_MS);
+
+	for (size_t i = 0; i < dirs.n_dirs; ++i) {
+		free(dirs.dirs[i]);
+	}
+	free(dirs.dirs);
+
+	return world->watcher ? 0 : -1;
+}
+
+LILV_API bool
+lilv_world_has_pending_changes(LilvWorld* world)
+{
+	return world->watcher && lilv_watcher_has_changes(world->watcher);
+}
+
+static int
+compare_paths(const void* a, const void* b)
+{
+	return strcmp(*(const char* const*)a, *(const char* const*)b);
+}
+
+LILV_API int
+lilv_world_apply_pending_changes(LilvWorld*  world,
+                                 LilvNodes** added,
+                                 LilvNodes** removed,
+                                 LilvNodes** changed)
+{
+	size_t n_paths = 0;
+	char** paths   = (world->watcher
+	                  ? lilv_watcher_take_changes(world->watcher, &n_paths)
+	                  : NULL);
+
+	// Load changed bundles in a stable order, since events arrive in any order
+	if (paths) {
+		qsort(paths, n_paths, sizeof(char*), compare_paths);
+	}
+
+	LilvNode** bundles = (LilvNode**)calloc(n_paths, sizeof(LilvNode*));
+	bool*      present = (bool*)calloc(n_paths, sizeof(bool));
+	for (size_t i = 0; i < n_paths; ++i) {
+		bundles[i] = lilv_new_bundle_uri(world, paths[i]);
+		present[i] = lilv_is_directory(paths[i]);
+	}
+
+	/* The watcher only reports bundles that had events, so reload them all
+	   rather than relying on stamps, which may miss a change made within the
+	   timestamp resolution of the file system. */
+	const int st = lilv_world_update(
+		world, bundles, present, n_paths, true, added, removed, changed);
+
+	for (size_t i = 0; i < n_paths; ++i) {
+		lilv_node_free(bundles[i]);
+		free(paths[i]);
+	}
+	free(present);
+	free(bundles);
+	free(paths);
+	return st;
+}
+
+SerdStatus
+lilv_world_load_file(LilvWorld* world, SerdReader* reader, const LilvNode* uri)
+{
+	const SerdStatus check = lilv_world_check_file(world, uri);
+	if (check) {
+		return check;
+	}
+
+	const uint8_t* const uri_str = sord_node_get_string(uri->node);
 	serd_reader_add_blank_prefix(reader, lilv_world_blank_node_prefix(world));
-	const SerdStatus st = serd_reader_read_file(reader, uri_str);
+	const SerdStatus st = lilv_reader_read_file(reader, uri_str);
 	if (st) {
 		LILV_ERRORF("Error loading file `%s'\n", lilv_node_as_string(uri));
 		return st;
 	}
 
-	zix_tree_insert((ZixTree*)world->loaded_files,
-	                lilv_node_duplicate(uri),
-	                NULL);
+	lilv_world_add_loaded_file(world, uri);
 	return SERD_SUCCESS;
 }
 
@@ -1130,6 +2614,9 @@ lilv_world_load_resource(LilvWorld*      world,
 	sord_iter_free(f);
 
 	sord_free(files);
+	if (n_read > 0) {
+		++world->revision;
+	}
 	return n_read;
 }
 
@@ -1178,6 +2665,7 @@ lilv_world_get_plugin_class(const LilvWorld* world)
 LILV_API const LilvPluginClasses*
 lilv_world_get_plugin_classes(const LilvWorld* world)
 {
+	lilv_world_load_classes_if_necessary((LilvWorld*)world);
 	return world->plugin_classes;
 }
 
@@ -1187,6 +2675,241 @@ lilv_world_get_all_plugins(const LilvWorld* world)
 	return world->plugins;
 }
 
+/** Set `id` to the bit index of feature `uri`, or return false on error. */
+bool
+lilv_world_get_feature_id(LilvWorld* world, const SordNode* uri, uint32_t* id)
+{
+	const LilvFeatureId key = {
+		(SordNode*)uri, (uint32_t)zix_hash_size(world->feature_ids) };
+
+	LilvFeatureId*  entry = NULL;
+	const ZixStatus st    = zix_hash_insert(
+		world->feature_ids, &key, (void**)&entry);
+	if (st == ZIX_STATUS_SUCCESS) {
+		entry->uri = sord_node_copy(uri);  // New feature, keep node alive
+	} else if (st != ZIX_STATUS_EXISTS) {
+		return false;
+	}
+
+	*id = entry->id;
+	return true;
+}
+
+LILV_API void
+lilv_world_set_supported_features(LilvWorld*                world,
+                                  const LV2_Feature* const* features)
+{
+	free(world->supported_features);
+	world->supported_features = NULL;
+	world->n_supported_words  = 0;
+
+	for (const LV2_Feature* const* f = features; f && *f; ++f) {
+		SordNode* uri = sord_new_uri(world->world, (const uint8_t*)(*f)->URI);
+		uint32_t  id  = 0;
+		if (lilv_world_get_feature_id(world, uri, &id)) {
+			lilv_bitset_set(&world->supported_features,
+			                &world->n_supported_words,
+			                id);
+		}  // Otherwise, plugins that require it are conservatively unhostable
+		sord_node_free(world->world, uri);
+	}
+}
+
+LILV_API LilvPlugins*
+lilv_world_filter_hostable_plugins(LilvWorld* world)
+{
+	LilvPlugins* result = lilv_plugins_new();
+	LILV_FOREACH(plugins, i, world->plugins) {
+		const LilvPlugin* plugin = lilv_plugins_get(world->plugins, i);
+		if (lilv_plugin_is_hostable(plugin)) {
+			zix_tree_insert((ZixTree*)result, (void*)plugin, NULL);
+		}
+	}
+	return result;
+}
+
+/** A data file to be parsed by lilv_world_preload_plugins(). */
+typedef struct {
+	LilvNode*       file;    ///< File URI
+	const SordNode* graph;   ///< Graph to load statements into
+	bool            parsed;  ///< True iff already parsed in an earlier pass
+} LilvPreloadFile;
+
+static uint32_t
+lilv_preload_file_hash(const void* value)
+{
+	return lilv_ptr_hash(((const LilvPreloadFile*)value)->file->node);
+}
+
+static bool
+lilv_preload_file_equals(const void* a, const void* b)
+{
+	return (((const LilvPreloadFile*)a)->file->node ==
+	        ((const LilvPreloadFile*)b)->file->node);
+}
+
+/** Add `file` to the files to be preloaded if it has not been loaded. */
+static void
+lilv_world_add_preload_file(LilvWorld*      world,
+                            ZixHash*        files,
+                            const SordNode* file,
+                            const SordNode* graph)
+{
+	if (sord_node_get_type(file) != SORD_URI) {
+		return;
+	}
+
+	LilvNode*             node  = lilv_node_new_from_node(world, file);
+	const LilvPreloadFile entry = { node, graph, false };
+	if (lilv_world_check_file(world, node) ||
+	    zix_hash_insert(files, &entry, NULL)) {
+		lilv_node_free(node);  // Already loaded, not loadable, or added
+	}
+}
+
+static void
+lilv_preload_file_collect(void* value, void* user_data)
+{
+	LilvPreloadFile*** next  = (LilvPreloadFile***)user_data;
+	LilvPreloadFile*   entry = (LilvPreloadFile*)value;
+	if (!entry->parsed) {
+		*(*next)++ = entry;
+	}
+}
+
+static void
+lilv_preload_file_free(void* value, void* user_data)
+{
+	lilv_node_free(((LilvPreloadFile*)value)->file);
+}
+
+/** Add the data files of the prototypes of `plugin` to be preloaded. */
+static void
+lilv_world_add_prototype_preload_files(LilvWorld*        world,
+                                       ZixHash*          files,
+                                       const LilvPlugin* plugin)
+{
+	// Prototype data files, which are loaded into their own graphs
+	SordIter* p = sord_search(world->model,
+	                          plugin->plugin_uri->node,
+	                          world->uris.lv2_prototype,
+	                          NULL,
+	                          NULL);
+	FOREACH_MATCH(p) {
+		const SordNode* prototype = sord_iter_get_node(p, SORD_OBJECT);
+		SordIter*       f         = sord_search(
+			world->model, prototype, world->uris.rdfs_seeAlso, NULL, NULL);
+		FOREACH_MATCH(f) {
+			const SordNode* file = sord_iter_get_node(f, SORD_OBJECT);
+			lilv_world_add_preload_file(world, files, file, file);
+		}
+		sord_iter_free(f);
+	}
+	sord_iter_free(p);
+}
+
+/**
+   Parse the files that have not been parsed yet concurrently, and merge them.
+
+   @return The number of files parsed, and `n_merged` is incremented by the
+   number of files that were merged successfully.
+*/
+static size_t
+lilv_world_preload_files(LilvWorld* world,
+                         ZixHash*   files,
+                         unsigned   n_threads,
+                         unsigned*  n_merged)
+{
+	// Parse all new files concurrently into private models
+	LilvPreloadFile** entries = (LilvPreloadFile**)calloc(
+		zix_hash_size(files) + 1, sizeof(LilvPreloadFile*));
+	LilvPreloadFile** next    = entries;
+	zix_hash_foreach(files, lilv_preload_file_collect, &next);
+
+	const size_t  n_jobs = (size_t)(next - entries);
+	LilvParseJob* jobs   = (LilvParseJob*)calloc(
+		n_jobs + 1, sizeof(LilvParseJob));
+	for (size_t i = 0; i < n_jobs; ++i) {
+		entries[i]->parsed = true;
+		lilv_parse_job_init(
+			&jobs[i], entries[i]->file, lilv_world_blank_node_prefix(world));
+	}
+
+	lilv_parse_jobs_run(jobs, n_jobs, n_threads);
+
+	// Merge results in this thread, leaving any failures to be reported later
+	for (size_t i = 0; i < n_jobs; ++i) {
+		if (!jobs[i].status) {
+			lilv_world_load_parsed(world, &jobs[i], entries[i]->graph);
+			++*n_merged;
+		}
+		lilv_parse_job_clear(&jobs[i]);
+	}
+	free(jobs);
+	free(entries);
+	return n_jobs;
+}
+
+LILV_API unsigned
+lilv_world_preload_plugins(LilvWorld*         world,
+                           const LilvPlugins* plugins,
+                           unsigned           n_threads)
+{
+	if (!plugins) {
+		plugins = world->plugins;
+	}
+
+	ZixHash* files = zix_hash_new(lilv_preload_file_hash,
+	                              lilv_preload_file_equals,
+	                              sizeof(LilvPreloadFile));
+
+	// Find every data file that loading the plugins would read
+	LILV_FOREACH(plugins, i, plugins) {
+		const LilvPlugin* plugin = lilv_plugins_get(plugins, i);
+		if (plugin->loaded) {
+			continue;
+		}
+
+		LILV_FOREACH(nodes, d, plugin->data_uris) {
+			const LilvNode* data_uri = lilv_nodes_get(plugin->data_uris, d);
+			lilv_world_add_preload_file(
+				world, files, data_uri->node, plugin->bundle_uri->node);
+		}
+
+		lilv_world_add_prototype_preload_files(world, files, plugin);
+	}
+
+	/* Parse the files found so far, then look again, since the merged data
+	   can declare more prototypes, until no new files are found. */
+	unsigned n_merged = 0;
+	while (lilv_world_preload_files(world, files, n_threads, &n_merged)) {
+		LILV_FOREACH(plugins, i, plugins) {
+			const LilvPlugin* plugin = lilv_plugins_get(plugins, i);
+			if (!plugin->loaded) {
+				lilv_world_add_prototype_preload_files(world, files, plugin);
+			}
+		}
+	}
+	zix_hash_foreach(files, lilv_preload_file_free, NULL);
+	zix_hash_free(files);
+
+	if (n_merged) {
+		++world->revision;  // Like lilv_world_load_resource()
+	}
+
+	// Finish loading plugins, which no longer needs to parse any files
+	unsigned n_loaded = 0;
+	LILV_FOREACH(plugins, i, plugins) {
+		const LilvPlugin* plugin = lilv_plugins_get(plugins, i);
+		if (!plugin->loaded) {
+			lilv_plugin_load_if_necessary(plugin);
+			++n_loaded;
+		}
+	}
+
+	return n_loaded;
+}
+
 LILV_API LilvNode*
 lilv_world_get_symbol(LilvWorld* world, const LilvNode* subject)
 {
@@ -21,6 +21,7 @@
 #include "../src/lilv_internal.h"
 
 #ifdef _WIN32
+#    include <windows.h>
 #    include <direct.h>
 #    include <io.h>
 #    define mkdir(path, flags) _mkdir(path)
@@ -28,6 +29,7 @@
 #    define unsetenv(n) SetEnvironmentVariable((n), NULL)
 #    define mkstemp(pat) _mktemp(pat)
 #else
+#    include <time.h>
 #    include <unistd.h>
 #endif
 
@@ -69,6 +71,7 @@ static LilvWorld* world;
 
 int test_count  = 0;
 int error_count = 0;
+int skip_count  = 0;
 
 static void
 delete_bundle(void)
@@ -204,6 +207,7 @@ set_env(const char* name, const char* value)
 /*****************************************************************************/
 
 #define TEST_CASE(name) { #name, test_##name }
+#define TEST_SKIPPED (-1)  // Returned by tests that can not run here
 #define TEST_ASSERT(check) do {\
 	test_count++;\
 	if (!(check)) {\
@@ -373,6 +377,39 @@ test_value(void)
 	LilvNode* uval_dup = lilv_node_duplicate(uval);
 	TEST_ASSERT(lilv_node_equals(uval, uval_dup));
 
+	// Nodes are interned, so equal nodes are usually identical
+	TEST_ASSERT(uval_dup == uval);
+	TEST_ASSERT(uval_e == uval);
+	TEST_ASSERT(sval_e == sval);
+	TEST_ASSERT(ival_e == ival);
+
+	// Interned nodes are freed when they are no longer referenced
+	const size_t n_nodes = zix_hash_size(world->nodes);
+	LilvNode*    unused  = lilv_new_uri(world, "http://example.org/unused");
+	TEST_ASSERT(zix_hash_size(world->nodes) == n_nodes + 1);
+	lilv_node_free(unused);
+	TEST_ASSERT(zix_hash_size(world->nodes) == n_nodes);
+
+	// Nodes appended out of order are sorted before they are read
+	LilvNodes* nodes  = lilv_nodes_new();
+	LilvNode*  vals[] = { uval, sval, ival, fval, uval };
+	for (unsigned i = 0; i < sizeof(vals) / sizeof(vals[0]); ++i) {
+		lilv_array_insert((LilvArray*)nodes, lilv_node_duplicate(vals[i]));
+	}
+	TEST_ASSERT(lilv_nodes_size(nodes) == 5);
+	const LilvNode* prev = NULL;
+	LILV_FOREACH(nodes, i, nodes) {
+		const LilvNode* node = lilv_nodes_get(nodes, i);
+		TEST_ASSERT((uintptr_t)prev <= (uintptr_t)node);
+		prev = node;
+	}
+	lilv_nodes_free(nodes);
+
+	// Floats that can not be represented exactly as strings keep their value
+	LilvNode* third = lilv_new_float(world, 1.0f / 3.0f);
+	TEST_ASSERT(lilv_node_as_float(third) == 1.0f / 3.0f);
+	lilv_node_free(third);
+
 	LilvNode* ifval = lilv_new_float(world, 42.0);
 	TEST_ASSERT(!lilv_node_equals(ival, ifval));
 	lilv_node_free(ifval);
@@ -386,6 +423,7 @@ test_value(void)
 	TEST_ASSERT(lilv_node_equals(nil, nil2));
 
 	lilv_node_free(uval);
+	TEST_ASSERT(!strcmp(lilv_node_as_uri(uval_e), "http://example.org"));
 	lilv_node_free(sval);
 	lilv_node_free(ival);
 	lilv_node_free(fval);
@@ -581,6 +619,52 @@ test_classes(void)
 				lilv_plugin_class_get_uri(plugin)));
 	}
 
+	// Check precomputed class hierarchy
+	TEST_ASSERT(!lilv_plugin_class_get_parent(plugin));
+	TEST_ASSERT(lilv_plugin_class_get_depth(plugin) == 0);
+	TEST_ASSERT(lilv_plugin_class_get_num_children(plugin) ==
+	            lilv_plugin_classes_size(children));
+	TEST_ASSERT(!lilv_plugin_class_get_child(
+		            plugin, lilv_plugin_class_get_num_children(plugin)));
+	for (unsigned i = 0; i < lilv_plugin_class_get_num_children(plugin); ++i) {
+		const LilvPluginClass* child = lilv_plugin_class_get_child(plugin, i);
+		TEST_ASSERT(lilv_plugin_class_get_parent(child) == plugin);
+		TEST_ASSERT(lilv_plugin_class_get_depth(child) == 1);
+		TEST_ASSERT(lilv_plugin_class_is_descendant_of(child, plugin));
+		TEST_ASSERT(!lilv_plugin_class_is_descendant_of(plugin, child));
+	}
+
+	LILV_FOREACH(plugin_classes, i, classes) {
+		const LilvPluginClass* c      = lilv_plugin_classes_get(classes, i);
+		const LilvPluginClass* parent = lilv_plugin_class_get_parent(c);
+		TEST_ASSERT(!lilv_plugin_class_is_descendant_of(c, c));
+		if (parent) {
+			TEST_ASSERT(lilv_plugin_class_is_descendant_of(c, parent));
+			TEST_ASSERT(lilv_plugin_class_get_depth(c) ==
+			            lilv_plugin_class_get_depth(parent) + 1);
+		}
+	}
+
+	// The loaded lv2:Plugin class has the same children as the root
+	const LilvPluginClass* loaded = lilv_plugin_classes_get_by_uri(
+		classes, lilv_plugin_class_get_uri(plugin));
+	TEST_ASSERT(loaded && loaded != plugin);
+	LilvPluginClasses* loaded_children = lilv_plugin_class_get_children(loaded);
+	TEST_ASSERT(lilv_plugin_classes_size(loaded_children) ==
+	            lilv_plugin_classes_size(children));
+	TEST_ASSERT(lilv_plugin_classes_size(loaded_children) > 0);
+	LILV_FOREACH(plugin_classes, i, loaded_children) {
+		const LilvPluginClass* c = lilv_plugin_classes_get(loaded_children, i);
+		TEST_ASSERT(lilv_plugin_class_get_parent(c) == plugin);
+		TEST_ASSERT(lilv_plugin_class_is_descendant_of(c, loaded));
+		TEST_ASSERT(lilv_plugin_class_is_descendant_of(c, plugin));
+	}
+	for (unsigned i = 0; i < lilv_plugin_class_get_num_children(plugin); ++i) {
+		TEST_ASSERT(lilv_plugin_class_get_child(loaded, i) ==
+		            lilv_plugin_class_get_child(plugin, i));
+	}
+	lilv_plugin_classes_free(loaded_children);
+
 	LilvNode* some_uri = lilv_new_uri(world, "http://example.org/whatever");
 	TEST_ASSERT(lilv_plugin_classes_get_by_uri(classes, some_uri) == NULL);
 	lilv_node_free(some_uri);
@@ -650,6 +734,7 @@ test_plugin(void)
 	lilv_node_free(rdf_type);
 
 	TEST_ASSERT(!lilv_plugin_is_replaced(plug));
+	TEST_ASSERT(!lilv_plugin_get_replaced_by(plug));
 	TEST_ASSERT(!lilv_plugin_get_related(plug, NULL));
 
 	const LilvNode* plug_bundle_uri = lilv_plugin_get_bundle_uri(plug);
@@ -743,6 +828,14 @@ test_plugin(void)
 	TEST_ASSERT(lilv_nodes_size(supported) == 2);
 	TEST_ASSERT(lilv_nodes_size(required) == 1);
 	TEST_ASSERT(lilv_nodes_size(optional) == 1);
+
+	// Results are allocated from an arena if one is attached
+	LilvArena* arena = lilv_arena_new(0);
+	lilv_world_set_arena(world, arena);
+	TEST_ASSERT(lilv_nodes_size(lilv_plugin_get_supported_features(plug)) == 2);
+	TEST_ASSERT(lilv_nodes_size(lilv_nodes_merge(required, optional)) == 2);
+	lilv_world_set_arena(world, NULL);
+	lilv_arena_free(arena);
 	lilv_nodes_free(supported);
 	lilv_nodes_free(required);
 	lilv_nodes_free(optional);
@@ -1013,7 +1106,15 @@ test_preset(void)
 			"] . \n"
 			"<http://example.org/preset> a pset:Preset ;"
 			"  lv2:appliesTo :plug ;"
-	                  "  rdfs:label \"some preset\" .\n")) {
+	                  "  rdfs:label \"some preset\" .\n"
+			"<http://example.org/preset2> a pset:Preset ;"
+			"  lv2:appliesTo :plug ;"
+			"  pset:bank <http://example.org/bank> .\n"
+			"<http://example.org/notapreset> a :Thing ; lv2:appliesTo :plug .\n"
+			"[] a pset:Preset ; lv2:appliesTo :plug .\n"
+			"<http://example.org/preset> rdfs:seeAlso <preset.ttl> .\n"
+			"<http://example.org/preset2> rdfs:seeAlso <preset2.ttl> .\n"
+			"<http://example.org/more> rdfs:seeAlso <preset3.ttl> .\n")) {
 		return 0;
 	}
 
@@ -1025,9 +1126,115 @@ test_preset(void)
 	LilvNode*  pset_Preset = lilv_new_uri(world, LV2_PRESETS__Preset);
 	LilvNodes* related     = lilv_plugin_get_related(plug, pset_Preset);
 
-	TEST_ASSERT(lilv_nodes_size(related) == 1);
-
+	TEST_ASSERT(lilv_nodes_size(related) == 3);
+
+	LilvNodes* all_related = lilv_plugin_get_related(plug, NULL);
+	TEST_ASSERT(lilv_nodes_size(all_related) == 4);
+
+	// Related resources are allocated from an arena if one is attached
+	LilvNode*  thing = lilv_new_uri(world, "http://example.org/Thing");
+	LilvArena* arena = lilv_arena_new(0);
+	lilv_world_set_arena(world, arena);
+	TEST_ASSERT(lilv_nodes_size(lilv_plugin_get_related(plug, pset_Preset)) == 3);
+	TEST_ASSERT(lilv_nodes_size(lilv_plugin_get_related(plug, NULL)) == 4);
+	TEST_ASSERT(lilv_nodes_size(lilv_plugin_get_related(plug, thing)) == 1);
+	lilv_world_set_arena(world, NULL);
+	lilv_arena_free(arena);
+	lilv_node_free(thing);
+
+	// The blank preset is related, but not indexed by URI
+	const LilvPresets* presets = lilv_plugin_get_presets(plug);
+	TEST_ASSERT(presets);
+	TEST_ASSERT(presets == lilv_plugin_get_presets(plug));
+	TEST_ASSERT(lilv_presets_size(presets) == 2);
+
+	LilvNode* preset_uri  = lilv_new_uri(world, "http://example.org/preset");
+	LilvNode* preset2_uri = lilv_new_uri(world, "http://example.org/preset2");
+	LilvNode* bank_uri    = lilv_new_uri(world, "http://example.org/bank");
+	LilvNode* not_uri     = lilv_new_uri(world, "http://example.org/notapreset");
+
+	const LilvPreset* preset = lilv_presets_get(presets,
+	                                            lilv_presets_begin(presets));
+	TEST_ASSERT(lilv_node_equals(lilv_preset_get_uri(preset), preset_uri));
+	TEST_ASSERT(!strcmp(lilv_node_as_string(lilv_preset_get_label(preset)),
+	                    "some preset"));
+	TEST_ASSERT(!lilv_preset_get_bank(preset));
+
+	const LilvPreset* preset2 = lilv_presets_get_by_uri(presets, preset2_uri);
+	TEST_ASSERT(preset2 && preset2 != preset);
+	TEST_ASSERT(!lilv_preset_get_label(preset2));
+	TEST_ASSERT(lilv_node_equals(lilv_preset_get_bank(preset2), bank_uri));
+
+	TEST_ASSERT(!lilv_presets_get_by_uri(presets, not_uri));
+
+	unsigned n_presets = 0;
+	LILV_FOREACH(presets, i, presets) {
+		TEST_ASSERT(lilv_nodes_contains(
+			related, lilv_preset_get_uri(lilv_presets_get(presets, i))));
+		++n_presets;
+	}
+	TEST_ASSERT(n_presets == 2);
+
+	// Load each preset while iterating, which updates the index in place
+	char* const preset_path  = lilv_strjoin(test_bundle_path, "/preset.ttl", NULL);
+	char* const preset2_path = lilv_strjoin(test_bundle_path, "/preset2.ttl", NULL);
+	write_file(preset_path,
+	           BUNDLE_PREFIXES
+	           "<http://example.org/preset> pset:bank <http://example.org/bank> .\n");
+	write_file(preset2_path,
+	           BUNDLE_PREFIXES
+	           "<http://example.org/preset2> rdfs:label \"second preset\" .\n");
+
+	n_presets = 0;
+	LILV_FOREACH(presets, i, presets) {
+		const LilvPreset* p = lilv_presets_get(presets, i);
+		TEST_ASSERT(lilv_world_load_resource(world, lilv_preset_get_uri(p)) == 1);
+		TEST_ASSERT(lilv_plugin_get_presets(plug) == presets);
+		TEST_ASSERT(lilv_presets_get_by_uri(presets, lilv_preset_get_uri(p)) == p);
+		++n_presets;
+	}
+	TEST_ASSERT(n_presets == 2);
+	TEST_ASSERT(lilv_presets_size(presets) == 2);
+	TEST_ASSERT(lilv_presets_get_by_uri(presets, preset_uri) == preset);
+	TEST_ASSERT(lilv_presets_get_by_uri(presets, preset2_uri) == preset2);
+	TEST_ASSERT(!strcmp(lilv_node_as_string(lilv_preset_get_label(preset)),
+	                    "some preset"));
+	TEST_ASSERT(lilv_node_equals(lilv_preset_get_bank(preset), bank_uri));
+	TEST_ASSERT(!strcmp(lilv_node_as_string(lilv_preset_get_label(preset2)),
+	                    "second preset"));
+
+	// Values are refreshed when data is removed
+	TEST_ASSERT(lilv_world_unload_resource(world, preset2_uri) == 1);
+	TEST_ASSERT(lilv_plugin_get_presets(plug) == presets);
+	TEST_ASSERT(lilv_presets_get_by_uri(presets, preset2_uri) == preset2);
+	TEST_ASSERT(!lilv_preset_get_label(preset2));
+
+	// Presets are added and removed with their data
+	char* const preset3_path = lilv_strjoin(test_bundle_path, "/preset3.ttl", NULL);
+	write_file(preset3_path,
+	           BUNDLE_PREFIXES
+	           "<http://example.org/preset3> a pset:Preset ; lv2:appliesTo :plug .\n");
+
+	LilvNode* more = lilv_new_uri(world, "http://example.org/more");
+	TEST_ASSERT(lilv_world_load_resource(world, more) == 1);
+	TEST_ASSERT(lilv_presets_size(lilv_plugin_get_presets(plug)) == 3);
+	TEST_ASSERT(lilv_world_unload_resource(world, more) == 1);
+	TEST_ASSERT(lilv_presets_size(lilv_plugin_get_presets(plug)) == 2);
+	TEST_ASSERT(lilv_presets_get_by_uri(presets, preset2_uri) == preset2);
+	lilv_node_free(more);
+
+	unlink(preset3_path);
+	free(preset3_path);
+	unlink(preset2_path);
+	unlink(preset_path);
+	free(preset2_path);
+	free(preset_path);
+	lilv_node_free(not_uri);
+	lilv_node_free(bank_uri);
+	lilv_node_free(preset2_uri);
+	lilv_node_free(preset_uri);
 	lilv_node_free(pset_Preset);
+	lilv_nodes_free(all_related);
 	lilv_nodes_free(related);
 	cleanup_uris();
 	return 1;
@@ -1040,7 +1247,9 @@ test_prototype(void)
 {
 	if (!start_bundle(MANIFEST_PREFIXES
 			":prot a lv2:PluginBase ; rdfs:seeAlso <plugin.ttl> .\n"
-			":plug a lv2:Plugin ; lv2:binary <inst" SHLIB_EXT "> ; lv2:prototype :prot .\n",
+			":plug a lv2:Plugin ; lv2:binary <inst" SHLIB_EXT "> ; lv2:prototype :prot .\n"
+			":foobar a lv2:Plugin ; lv2:binary <inst" SHLIB_EXT "> ; lv2:prototype :prot .\n"
+			":extra rdfs:seeAlso <extra.ttl> .\n",
 			BUNDLE_PREFIXES
 			":prot a lv2:Plugin ; a lv2:CompressorPlugin ; "
 			LICENSE_GPL " ; "
@@ -1079,6 +1288,36 @@ test_prototype(void)
 	const LilvNode* binary = lilv_plugin_get_library_uri(plug);
 	TEST_ASSERT(strstr(lilv_node_as_string(binary), "inst" SHLIB_EXT));
 
+	TEST_ASSERT(lilv_plugin_get_num_ports(plug) == 3);
+
+	// Load more data about the prototype after it has been expanded once
+	char* const extra_path = lilv_strjoin(test_bundle_path, "/extra.ttl", NULL);
+	write_file(extra_path,
+	           BUNDLE_PREFIXES
+	           ":prot lv2:optionalFeature <http://example.org/feature> .\n");
+
+	LilvNode* extra   = lilv_new_uri(world, "http://example.org/extra");
+	LilvNode* feature = lilv_new_uri(world, "http://example.org/feature");
+	TEST_ASSERT(lilv_world_load_resource(world, extra) == 1);
+	TEST_ASSERT(!lilv_plugin_has_feature(plug, feature));
+
+	// Plugins with the same prototype share its port descriptions
+	const LilvPlugin* plug2 = lilv_plugins_get_by_uri(plugins, plugin2_uri_value);
+	TEST_ASSERT(plug2);
+	TEST_ASSERT(lilv_plugin_get_num_ports(plug2) == 3);
+	for (uint32_t i = 0; i < 3; ++i) {
+		TEST_ASSERT(lilv_node_equals(
+			lilv_port_get_node(plug, lilv_plugin_get_port_by_index(plug, i)),
+			lilv_port_get_node(plug2, lilv_plugin_get_port_by_index(plug2, i))));
+	}
+
+	// Plugins loaded afterwards inherit the new data
+	TEST_ASSERT(lilv_plugin_has_feature(plug2, feature));
+
+	lilv_node_free(feature);
+	lilv_node_free(extra);
+	unlink(extra_path);
+	free(extra_path);
 	cleanup_uris();
 	return 1;
 }
@@ -1268,6 +1507,39 @@ test_port(void)
 	TEST_ASSERT(!strcmp(lilv_node_as_string(lilv_nodes_get_first(homepages)),
 			"http://example.org/someplug"));
 
+	LilvQuery* query = lilv_plugin_query_value(plug, homepage_p);
+	TEST_ASSERT(!lilv_query_is_end(query));
+	TEST_ASSERT(lilv_query_get(query) == lilv_nodes_get_first(homepages));
+	TEST_ASSERT(lilv_query_next(query));
+	TEST_ASSERT(lilv_query_is_end(query));
+	TEST_ASSERT(!lilv_query_get(query));
+	lilv_query_free(query);
+
+	// Small blocks to exercise growing and reusing the arena
+	LilvArena* arena = lilv_arena_new(64);
+	TEST_ASSERT(arena);
+	lilv_world_set_arena(world, arena);
+	for (unsigned i = 0; i < 2; ++i) {
+		for (unsigned j = 0; j < 8; ++j) {
+			LilvNodes* arena_homepages = lilv_plugin_get_value(plug, homepage_p);
+			TEST_ASSERT(lilv_nodes_size(arena_homepages) == 1);
+			TEST_ASSERT(lilv_nodes_get_first(arena_homepages) ==
+			            lilv_nodes_get_first(homepages));
+			lilv_nodes_free(arena_homepages);  // Does nothing
+
+			LilvScalePoints* arena_points = lilv_port_get_scale_points(plug, p);
+			TEST_ASSERT(lilv_scale_points_size(arena_points) == 2);
+			const LilvScalePoint* point = lilv_scale_points_get(
+				arena_points, lilv_scale_points_begin(arena_points));
+			const char* label = lilv_node_as_string(
+				lilv_scale_point_get_label(point));
+			TEST_ASSERT(!strcmp(label, "Sin") || !strcmp(label, "Cos"));
+		}
+		lilv_arena_reset(arena);
+	}
+	lilv_world_set_arena(world, NULL);
+	lilv_arena_free(arena);
+
 	LilvNode *min, *max, *def;
 	lilv_port_get_range(plug, p, &def, &min, &max);
 	TEST_ASSERT(def);
@@ -1299,6 +1571,16 @@ test_port(void)
 	                    "store"));
 	lilv_nodes_free(names);
 
+	unsigned n_names = 0;
+	query = lilv_world_query(world, lilv_port_get_node(plug, p), name_p, NULL);
+	for (; !lilv_query_is_end(query); lilv_query_next(query)) {
+		TEST_ASSERT(!strcmp(lilv_node_as_string(lilv_query_get(query)),
+		                    "store"));
+		++n_names;
+	}
+	TEST_ASSERT(n_names == 1);
+	lilv_query_free(query);
+
 	LilvNode* true_val  = lilv_new_bool(world, true);
 	LilvNode* false_val = lilv_new_bool(world, false);
 
@@ -1308,6 +1590,14 @@ test_port(void)
 	names = lilv_port_get_value(plug, p, name_p);
 	TEST_ASSERT(lilv_nodes_size(names) == 4);
 	lilv_nodes_free(names);
+
+	n_names = 0;
+	query   = lilv_world_query(world, lilv_port_get_node(plug, p), name_p, NULL);
+	for (; !lilv_query_is_end(query); lilv_query_next(query)) {
+		++n_names;
+	}
+	TEST_ASSERT(n_names == 4);
+	lilv_query_free(query);
 	lilv_world_set_option(world, LILV_OPTION_FILTER_LANG, true_val);
 
 	lilv_node_free(false_val);
@@ -1363,6 +1653,126 @@ test_port(void)
 
 /*****************************************************************************/
 
+static int
+test_port_table(void)
+{
+	if (!start_bundle(MANIFEST_PREFIXES
+			":plug a lv2:Plugin ; lv2:binary <foo" SHLIB_EXT "> ; rdfs:seeAlso <plugin.ttl> .\n",
+			BUNDLE_PREFIXES PREFIX_LV2EV
+			":plug a lv2:Plugin ; "
+			PLUGIN_NAME("Test plugin") " ; "
+			LICENSE_GPL " ; "
+			"lv2:port [ "
+			"  a lv2:ControlPort ; a lv2:InputPort ; "
+			"  lv2:index 0 ; lv2:symbol \"gain\" ; lv2:name \"Gain\" ; "
+			"  lv2:portProperty lv2:integer , lv2:toggled ; "
+			"  lv2:designation <http://example.org/gain> ; "
+			"  lv2:minimum -1 ; lv2:maximum 1.0 ; lv2:default 0.5 ; "
+			"] , [\n"
+			"  a lv2:AudioPort ; a lv2:OutputPort ; "
+			"  lv2:index 1 ; lv2:symbol \"out\" ; lv2:name \"Out\" ; "
+			"  lv2:portProperty lv2:connectionOptional ; "
+			"] , [\n"
+			"  a atom:AtomPort ; a lv2:InputPort ; "
+			"  lv2:index 2 ; lv2:symbol \"events\" ; lv2:name \"Events\" ; "
+			"  lv2:default \"1\" ; "
+			"] .")) {
+		return 0;
+	}
+
+	init_uris();
+	const LilvPlugins*   plugins = lilv_world_get_all_plugins(world);
+	const LilvPlugin*    plug    = lilv_plugins_get_by_uri(plugins, plugin_uri_value);
+	const LilvPortTable* table   = lilv_plugin_get_port_table(plug);
+	TEST_ASSERT(table);
+	TEST_ASSERT(lilv_plugin_get_port_table(plug) == table);
+	TEST_ASSERT(lilv_port_table_get_num_ports(table) == 3);
+
+	const LilvNode* const* symbols = lilv_port_table_get_symbols(table);
+	TEST_ASSERT(!strcmp(lilv_node_as_string(symbols[0]), "gain"));
+	TEST_ASSERT(!strcmp(lilv_node_as_string(symbols[1]), "out"));
+	TEST_ASSERT(!strcmp(lilv_node_as_string(symbols[2]), "events"));
+
+	const uint32_t* flags = lilv_port_table_get_flags(table);
+	TEST_ASSERT(flags[0] == (LILV_PORT_CONTROL | LILV_PORT_INPUT));
+	TEST_ASSERT(flags[1] == (LILV_PORT_AUDIO | LILV_PORT_OUTPUT));
+	TEST_ASSERT(flags[2] == (LILV_PORT_ATOM | LILV_PORT_INPUT));
+
+	const uint32_t* props = lilv_port_table_get_properties(table);
+	TEST_ASSERT(props[0] == (LILV_PORT_INTEGER | LILV_PORT_TOGGLED));
+	TEST_ASSERT(props[1] == LILV_PORT_CONNECTION_OPTIONAL);
+	TEST_ASSERT(props[2] == 0);
+
+	const float* mins = lilv_port_table_get_minimums(table);
+	const float* maxs = lilv_port_table_get_maximums(table);
+	const float* defs = lilv_port_table_get_defaults(table);
+	TEST_ASSERT(mins[0] == -1.0f);
+	TEST_ASSERT(maxs[0] == 1.0f);
+	TEST_ASSERT(defs[0] == 0.5f);
+	TEST_ASSERT(isnan(mins[1]) && isnan(maxs[1]) && isnan(defs[1]));
+
+	// Values are converted like lilv_node_as_float()
+	for (uint32_t i = 0; i < 3; ++i) {
+		const LilvPort* port = lilv_plugin_get_port_by_index(plug, i);
+		LilvNode*       def  = NULL;
+		LilvNode*       min  = NULL;
+		LilvNode*       max  = NULL;
+		lilv_port_get_range(plug, port, &def, &min, &max);
+		TEST_ASSERT(isnan(defs[i]) ? isnan(lilv_node_as_float(def))
+		                           : defs[i] == lilv_node_as_float(def));
+		TEST_ASSERT(isnan(mins[i]) ? isnan(lilv_node_as_float(min))
+		                           : mins[i] == lilv_node_as_float(min));
+		TEST_ASSERT(isnan(maxs[i]) ? isnan(lilv_node_as_float(max))
+		                           : maxs[i] == lilv_node_as_float(max));
+		lilv_node_free(max);
+		lilv_node_free(min);
+		lilv_node_free(def);
+	}
+
+	float ranges[3];
+	lilv_plugin_get_port_ranges_float(plug, NULL, ranges, NULL);
+	TEST_ASSERT(ranges[0] == 1.0f);
+	TEST_ASSERT(isnan(ranges[1]));
+	TEST_ASSERT(isnan(ranges[2]));
+
+	LilvNode* gain = lilv_new_uri(world, "http://example.org/gain");
+	const LilvNode* const* designations = lilv_port_table_get_designations(table);
+	TEST_ASSERT(lilv_node_equals(designations[0], gain));
+	TEST_ASSERT(!designations[1]);
+	TEST_ASSERT(!designations[2]);
+
+	LilvNode* control = lilv_new_uri(world, LV2_CORE__ControlPort);
+	LilvNode* audio   = lilv_new_uri(world, LV2_CORE__AudioPort);
+	TEST_ASSERT(lilv_plugin_get_port_by_designation(plug, NULL, gain) ==
+	            lilv_plugin_get_port_by_index(plug, 0));
+	TEST_ASSERT(lilv_plugin_get_port_by_designation(plug, control, gain) ==
+	            lilv_plugin_get_port_by_index(plug, 0));
+	TEST_ASSERT(!lilv_plugin_get_port_by_designation(plug, audio, gain));
+	TEST_ASSERT(!lilv_plugin_get_port_by_designation(plug, NULL, control));
+	lilv_node_free(audio);
+	lilv_node_free(control);
+	lilv_node_free(gain);
+
+	LilvNode* events     = lilv_new_string(world, "events");
+	LilvNode* events_uri = lilv_new_uri(world, "events");
+	LilvNode* missing    = lilv_new_string(world, "missing");
+	TEST_ASSERT(lilv_plugin_get_port_by_symbol(plug, events) ==
+	            lilv_plugin_get_port_by_index(plug, 2));
+	TEST_ASSERT(!lilv_plugin_get_port_by_symbol(plug, events_uri));
+	TEST_ASSERT(!lilv_plugin_get_port_by_symbol(plug, missing));
+	lilv_node_free(missing);
+	lilv_node_free(events_uri);
+	lilv_node_free(events);
+
+	TEST_ASSERT(!lilv_plugin_has_latency(plug));
+	TEST_ASSERT(lilv_plugin_get_latency_port_index(plug) == (uint32_t)-1);
+
+	cleanup_uris();
+	return 1;
+}
+
+/*****************************************************************************/
+
 static unsigned
 ui_supported(const char* container_type_uri,
              const char* ui_type_uri)
@@ -1418,6 +1828,18 @@ test_ui(void)
 	const LilvUI* ui0 = lilv_uis_get(uis, lilv_uis_begin(uis));
 	TEST_ASSERT(ui0);
 
+	const LilvUI* prev_ui = NULL;
+	unsigned      n_uis   = 0;
+	LILV_FOREACH(uis, u, uis) {
+		const LilvUI* ui = lilv_uis_get(uis, u);
+		TEST_ASSERT(!prev_ui ||
+		            strcmp(lilv_node_as_uri(lilv_ui_get_uri(prev_ui)),
+		                   lilv_node_as_uri(lilv_ui_get_uri(ui))) < 0);
+		prev_ui = ui;
+		++n_uis;
+	}
+	TEST_ASSERT(n_uis == 4);
+
 	LilvNode* ui_uri = lilv_new_uri(world, "http://example.org/ui");
 	LilvNode* ui2_uri = lilv_new_uri(world, "http://example.org/ui3");
 	LilvNode* ui3_uri = lilv_new_uri(world, "http://example.org/ui4");
@@ -1466,6 +1888,17 @@ test_ui(void)
 	LilvNode* expected_uri = lilv_new_uri(world, ui_binary_uri_str);
 	TEST_ASSERT(lilv_node_equals(expected_uri, ui_binary_uri));
 
+	const LilvUIs* all_uis = lilv_plugin_get_all_uis(plug);
+	TEST_ASSERT(all_uis);
+	TEST_ASSERT(all_uis == lilv_plugin_get_all_uis(plug));
+	TEST_ASSERT(lilv_uis_size(all_uis) == 4);
+
+	const LilvUI* shared_ui0 = lilv_uis_get_by_uri(all_uis, ui_uri);
+	TEST_ASSERT(shared_ui0 && shared_ui0 != ui0);
+	TEST_ASSERT(lilv_node_equals(lilv_ui_get_binary_uri(shared_ui0),
+	                             ui_binary_uri));
+	TEST_ASSERT(lilv_ui_is_a(shared_ui0, ui_class_uri));
+
 	free(ui_binary_uri_str);
 	lilv_node_free(unknown_ui_class_uri);
 	lilv_node_free(ui_class_uri);
@@ -2043,6 +2476,17 @@ test_world(void)
 	matches = lilv_world_find_nodes(world, NULL, uri, NULL);
 	TEST_ASSERT(!matches);
 
+	TEST_ASSERT(!lilv_world_query(world, num, uri, NULL));
+	TEST_ASSERT(!lilv_world_query(world, NULL, num, NULL));
+	TEST_ASSERT(!lilv_world_query(world, NULL, uri, NULL));
+
+	LilvQuery* query = lilv_world_query(world, uri, uri, NULL);
+	TEST_ASSERT(query);
+	TEST_ASSERT(lilv_query_is_end(query));
+	TEST_ASSERT(!lilv_query_get(query));
+	TEST_ASSERT(lilv_query_next(query));
+	lilv_query_free(query);
+
 	lilv_node_free(uri);
 	lilv_node_free(num);
 
@@ -2097,6 +2541,7 @@ test_reload_bundle(void)
 
 	// Check that plugin is no longer in the world's plugin list
 	TEST_ASSERT(lilv_plugins_size(plugins) == 0);
+	TEST_ASSERT(!lilv_plugins_get_by_uri(plugins, plugin_uri_value));
 
 	// Load new bundle
 	lilv_world_load_bundle(world, bundle_uri);
@@ -2106,6 +2551,11 @@ test_reload_bundle(void)
 	TEST_ASSERT(plug2);
 	TEST_ASSERT(plug2 == plug);
 
+	// Check that a plugin can be found by an equivalent URI node
+	LilvNode* plug_uri = lilv_new_uri(world, "http://example.org/plug");
+	TEST_ASSERT(lilv_plugins_get_by_uri(plugins, plug_uri) == plug);
+	lilv_node_free(plug_uri);
+
 	// Check that plugin now has new name
 	LilvNode* name2 = lilv_plugin_get_name(plug2);
 	TEST_ASSERT(name2);
@@ -2125,6 +2575,73 @@ test_reload_bundle(void)
 
 /*****************************************************************************/
 
+static int
+test_unload_bundle_files(void)
+{
+	create_bundle(MANIFEST_PREFIXES
+	              ":plug a lv2:Plugin ; lv2:binary <foo" SHLIB_EXT "> ;"
+	              " rdfs:seeAlso <plugin.ttl> .\n"
+	              ":thing rdfs:seeAlso <thing.ttl> .\n",
+	              BUNDLE_PREFIXES
+	              ":plug a lv2:Plugin ; "
+	              PLUGIN_NAME("Test plugin") " .");
+
+	char thing_path[sizeof(test_bundle_path) + sizeof("/thing.ttl")];
+	snprintf(thing_path, sizeof(thing_path), "%s/thing.ttl", test_bundle_path);
+	write_file(thing_path, BUNDLE_PREFIXES ":thing rdfs:label \"Thing\" .\n");
+
+	if (!init_world()) {
+		return 0;
+	}
+
+	init_uris();
+
+	LilvNode* bundle_uri = lilv_new_uri(world, test_bundle_uri);
+	LilvNode* thing      = lilv_new_uri(world, "http://example.org/thing");
+	LilvNode* doap_name  = lilv_new_uri(world, LILV_NS_DOAP "name");
+	LilvNode* rdfs_label = lilv_new_uri(world, LILV_NS_RDFS "label");
+
+	// Load both data files of the bundle
+	lilv_world_load_bundle(world, bundle_uri);
+	const LilvPlugins* plugins = lilv_world_get_all_plugins(world);
+	const LilvPlugin*  plug = lilv_plugins_get_by_uri(plugins, plugin_uri_value);
+	TEST_ASSERT(plug);
+	LilvNode* name = lilv_plugin_get_name(plug);  // Loads plugin.ttl
+	TEST_ASSERT(name);
+	lilv_node_free(name);
+	TEST_ASSERT(lilv_world_load_resource(world, thing) == 1);
+	TEST_ASSERT(lilv_world_ask(world, plugin_uri_value, doap_name, NULL));
+	TEST_ASSERT(lilv_world_ask(world, thing, rdfs_label, NULL));
+
+	// Unloading the bundle drops the statements from its data files
+	TEST_ASSERT(!lilv_world_unload_bundle(world, bundle_uri));
+	TEST_ASSERT(!lilv_world_ask(world, plugin_uri_value, doap_name, NULL));
+	TEST_ASSERT(!lilv_world_ask(world, thing, rdfs_label, NULL));
+
+	// Loading the bundle again reads the data files again
+	lilv_world_load_bundle(world, bundle_uri);
+	plug = lilv_plugins_get_by_uri(plugins, plugin_uri_value);
+	TEST_ASSERT(plug);
+	name = lilv_plugin_get_name(plug);
+	TEST_ASSERT(name && !strcmp(lilv_node_as_string(name), "Test plugin"));
+	lilv_node_free(name);
+	TEST_ASSERT(lilv_world_load_resource(world, thing) == 1);
+	TEST_ASSERT(lilv_world_ask(world, thing, rdfs_label, NULL));
+
+	lilv_node_free(rdfs_label);
+	lilv_node_free(doap_name);
+	lilv_node_free(thing);
+	lilv_node_free(bundle_uri);
+	cleanup_uris();
+	lilv_world_free(world);
+	world = NULL;
+	unlink(thing_path);
+	delete_bundle();
+	return 1;
+}
+
+/*****************************************************************************/
+
 static int
 test_replace_version(void)
 {
@@ -2202,6 +2719,256 @@ test_replace_version(void)
 
 /*****************************************************************************/
 
+static int
+test_replaced_by(void)
+{
+	if (!start_bundle(
+		    MANIFEST_PREFIXES
+		    "@prefix dcterms: <http://purl.org/dc/terms/> .\n"
+		    ":plug a lv2:Plugin ; lv2:binary <foo" SHLIB_EXT "> ; rdfs:seeAlso <plugin.ttl> .\n"
+		    ":foobar a lv2:Plugin ; lv2:binary <foo" SHLIB_EXT "> ;"
+		    " dcterms:replaces :plug .\n"
+		    ":missing dcterms:replaces :foobar .\n",
+		    BUNDLE_PREFIXES
+		    ":plug a lv2:Plugin ; "
+		    PLUGIN_NAME("Test plugin") " .")) {
+		return 0;
+	}
+
+	init_uris();
+
+	const LilvPlugins* plugins = lilv_world_get_all_plugins(world);
+	const LilvPlugin*  plug    = lilv_plugins_get_by_uri(plugins, plugin_uri_value);
+	const LilvPlugin*  plug2   = lilv_plugins_get_by_uri(plugins, plugin2_uri_value);
+	TEST_ASSERT(plug);
+	TEST_ASSERT(plug2);
+
+	// Replaced by a known plugin
+	TEST_ASSERT(lilv_plugin_is_replaced(plug));
+	TEST_ASSERT(lilv_node_equals(lilv_plugin_get_replaced_by(plug),
+	                             plugin2_uri_value));
+
+	// Replaced only by an unknown plugin
+	TEST_ASSERT(lilv_plugin_is_replaced(plug2));
+	TEST_ASSERT(!lilv_plugin_get_replaced_by(plug2));
+
+	cleanup_uris();
+	return 1;
+}
+
+/*****************************************************************************/
+
+static int
+test_hostable(void)
+{
+	if (!start_bundle(
+		    MANIFEST_PREFIXES
+		    ":plug a lv2:Plugin ; lv2:binary <foo" SHLIB_EXT "> ; rdfs:seeAlso <plugin.ttl> .\n"
+		    ":foobar a lv2:Plugin ; lv2:binary <foo" SHLIB_EXT "> ;"
+		    " lv2:optionalFeature <http://example.org/optional> .\n",
+		    BUNDLE_PREFIXES
+		    ":plug a lv2:Plugin ; "
+		    PLUGIN_NAME("Test plugin") " ; "
+		    "lv2:requiredFeature <http://example.org/required> , "
+		    "<http://example.org/other> .")) {
+		return 0;
+	}
+
+	init_uris();
+
+	// No supported features, so only plugins with no requirements
+	LilvPlugins* hostable = lilv_world_filter_hostable_plugins(world);
+	TEST_ASSERT(lilv_plugins_size(hostable) == 1);
+	TEST_ASSERT(lilv_plugins_get_by_uri(hostable, plugin2_uri_value));
+	lilv_plugins_free(hostable);
+
+	// Only some of the required features
+	const LV2_Feature        required  = { "http://example.org/required", NULL };
+	const LV2_Feature        other     = { "http://example.org/other", NULL };
+	const LV2_Feature        unused    = { "http://example.org/unused", NULL };
+	const LV2_Feature* const partial[] = { &unused, &required, NULL };
+	lilv_world_set_supported_features(world, partial);
+	hostable = lilv_world_filter_hostable_plugins(world);
+	TEST_ASSERT(lilv_plugins_size(hostable) == 1);
+	TEST_ASSERT(!lilv_plugins_get_by_uri(hostable, plugin_uri_value));
+	lilv_plugins_free(hostable);
+
+	// All required features
+	const LV2_Feature* const all[] = { &other, &unused, &required, NULL };
+	lilv_world_set_supported_features(world, all);
+	hostable = lilv_world_filter_hostable_plugins(world);
+	TEST_ASSERT(lilv_plugins_size(hostable) == 2);
+	TEST_ASSERT(lilv_plugins_get_by_uri(hostable, plugin_uri_value));
+	lilv_plugins_free(hostable);
+
+	// Reset to no features
+	lilv_world_set_supported_features(world, NULL);
+	hostable = lilv_world_filter_hostable_plugins(world);
+	TEST_ASSERT(lilv_plugins_size(hostable) == 1);
+	lilv_plugins_free(hostable);
+
+	cleanup_uris();
+	return 1;
+}
+
+/*****************************************************************************/
+
+static int
+test_summary(void)
+{
+	if (!start_bundle(
+		    MANIFEST_PREFIXES PREFIX_DOAP
+		    ":plug a lv2:Plugin , lv2:CompressorPlugin ; "
+		    PLUGIN_NAME("Test plugin") " ; "
+		    "lv2:minorVersion 2 ; lv2:microVersion 4 ; "
+		    "lv2:binary <foo" SHLIB_EXT "> ; rdfs:seeAlso <plugin.ttl> .\n"
+		    ":foobar a lv2:Plugin ; lv2:binary <foo" SHLIB_EXT "> ; "
+		    "rdfs:seeAlso <plugin.ttl> .\n",
+		    BUNDLE_PREFIXES
+		    ":plug lv2:project <http://example.org/project> ; "
+		    "lv2:port [ a lv2:ControlPort , lv2:InputPort ; "
+		    "  lv2:index 0 ; lv2:symbol \"gain\" ; lv2:name \"Gain\" ] .\n"
+		    ":foobar a lv2:Plugin , lv2:CompressorPlugin ; "
+		    "doap:name \"Second plugin\" ; "
+		    "lv2:project <http://example.org/project> .")) {
+		return 0;
+	}
+
+	init_uris();
+
+	const LilvPlugins* plugins = lilv_world_get_all_plugins(world);
+	const LilvPlugin*  plug    = lilv_plugins_get_by_uri(plugins, plugin_uri_value);
+	TEST_ASSERT(plug);
+
+	LilvNode* lv2_port = lilv_new_uri(world, LV2_CORE__port);
+
+	// Everything is in the manifest, so the data file is not loaded
+	const LilvPluginSummary* summary = lilv_plugin_get_summary(plug);
+	TEST_ASSERT(summary);
+	TEST_ASSERT(lilv_plugin_get_summary(plug) == summary);
+	TEST_ASSERT(!strcmp(lilv_node_as_string(
+		                    lilv_plugin_summary_get_name(summary)),
+	                    "Test plugin"));
+	TEST_ASSERT(!strcmp(lilv_node_as_uri(lilv_plugin_class_get_uri(
+		                    lilv_plugin_summary_get_class(summary))),
+	                    "http://lv2plug.in/ns/lv2core#CompressorPlugin"));
+	TEST_ASSERT(lilv_node_is_uri(lilv_plugin_summary_get_library_uri(summary)));
+	TEST_ASSERT(lilv_plugin_summary_get_minor_version(summary) == 2);
+	TEST_ASSERT(lilv_plugin_summary_get_micro_version(summary) == 4);
+	TEST_ASSERT(!lilv_world_ask(world, plugin_uri_value, lv2_port, NULL));
+	TEST_ASSERT(lilv_node_equals(lilv_plugin_summary_get_library_uri(summary),
+	                             lilv_plugin_get_library_uri(plug)));
+
+	// The project is only in the data file, so it is filled in once loaded
+	TEST_ASSERT(lilv_world_ask(world, plugin_uri_value, lv2_port, NULL));
+	TEST_ASSERT(lilv_plugin_get_summary(plug) == summary);
+	TEST_ASSERT(!strcmp(lilv_node_as_uri(
+		                    lilv_plugin_summary_get_project(summary)),
+	                    "http://example.org/project"));
+	TEST_ASSERT(!strcmp(lilv_node_as_string(
+		                    lilv_plugin_summary_get_name(summary)),
+	                    "Test plugin"));
+
+	// The name and class are only in the data file, so it is loaded
+	const LilvPlugin* plug2 = lilv_plugins_get_by_uri(plugins, plugin2_uri_value);
+	TEST_ASSERT(plug2);
+	summary = lilv_plugin_get_summary(plug2);
+	TEST_ASSERT(!strcmp(lilv_node_as_string(
+		                    lilv_plugin_summary_get_name(summary)),
+	                    "Second plugin"));
+	TEST_ASSERT(!strcmp(lilv_node_as_uri(lilv_plugin_class_get_uri(
+		                    lilv_plugin_summary_get_class(summary))),
+	                    "http://lv2plug.in/ns/lv2core#CompressorPlugin"));
+	TEST_ASSERT(lilv_plugin_summary_get_library_uri(summary));
+	TEST_ASSERT(!strcmp(lilv_node_as_uri(
+		                    lilv_plugin_summary_get_project(summary)),
+	                    "http://example.org/project"));
+	TEST_ASSERT(lilv_plugin_summary_get_minor_version(summary) == 0);
+	TEST_ASSERT(lilv_world_ask(world, plugin_uri_value, lv2_port, NULL));
+
+	lilv_node_free(lv2_port);
+	cleanup_uris();
+	return 1;
+}
+
+/*****************************************************************************/
+
+static int
+test_preload(void)
+{
+	if (!start_bundle(
+		    MANIFEST_PREFIXES
+		    ":prot a lv2:PluginBase ; rdfs:seeAlso <prototype.ttl> .\n"
+		    ":plug a lv2:Plugin ; lv2:binary <foo" SHLIB_EXT "> ; rdfs:seeAlso <plugin.ttl> .\n"
+		    ":foobar a lv2:Plugin ; lv2:binary <foo" SHLIB_EXT "> ; "
+		    "lv2:prototype :prot ; rdfs:seeAlso <plugin.ttl> .\n",
+		    BUNDLE_PREFIXES
+		    ":plug a lv2:Plugin ; "
+		    PLUGIN_NAME("Test plugin") " ; "
+		    "lv2:prototype :base ; "
+		    "lv2:port [ a lv2:ControlPort , lv2:InputPort ; "
+		    "  lv2:index 0 ; lv2:symbol \"gain\" ; lv2:name \"Gain\" ] .\n"
+		    ":base rdfs:seeAlso <base.ttl> .\n"
+		    ":foobar " PLUGIN_NAME("Second plugin") " .")) {
+		return 0;
+	}
+
+	char prototype_path[sizeof(test_bundle_path) + sizeof("/prototype.ttl")];
+	snprintf(prototype_path, sizeof(prototype_path), "%s/prototype.ttl",
+	         test_bundle_path);
+	write_file(prototype_path,
+	           PREFIX_LINE PREFIX_LV2
+	           ":prot lv2:port [ a lv2:ControlPort , lv2:OutputPort ; "
+	           "  lv2:index 0 ; lv2:symbol \"out\" ; lv2:name \"Out\" ] .\n");
+
+	// Prototype that is only declared in a plugin data file
+	char base_path[sizeof(test_bundle_path) + sizeof("/base.ttl")];
+	snprintf(base_path, sizeof(base_path), "%s/base.ttl", test_bundle_path);
+	write_file(base_path,
+	           PREFIX_LINE PREFIX_LV2
+	           ":base lv2:optionalFeature <http://example.org/feature> .\n");
+
+	init_uris();
+
+	LilvNode* lv2_port = lilv_new_uri(world, LV2_CORE__port);
+	TEST_ASSERT(!lilv_world_ask(world, plugin_uri_value, lv2_port, NULL));
+
+	TEST_ASSERT(lilv_world_preload_plugins(world, NULL, 4) == 2);
+	TEST_ASSERT(lilv_world_ask(world, plugin_uri_value, lv2_port, NULL));
+	TEST_ASSERT(lilv_world_ask(world, plugin2_uri_value, lv2_port, NULL));
+
+	const LilvPlugins* plugins = lilv_world_get_all_plugins(world);
+	const LilvPlugin*  plug    = lilv_plugins_get_by_uri(plugins, plugin_uri_value);
+	const LilvPlugin*  plug2   = lilv_plugins_get_by_uri(plugins, plugin2_uri_value);
+	TEST_ASSERT(lilv_plugin_get_num_ports(plug) == 1);
+	TEST_ASSERT(lilv_plugin_get_num_ports(plug2) == 1);
+
+	LilvNode* name = lilv_plugin_get_name(plug2);
+	TEST_ASSERT(!strcmp(lilv_node_as_string(name), "Second plugin"));
+	lilv_node_free(name);
+
+	// The data of a prototype found in a merged data file is loaded too
+	LilvNode* base    = lilv_new_uri(world, "http://example.org/base");
+	LilvNode* feature = lilv_new_uri(world, "http://example.org/feature");
+	LilvNode* opt     = lilv_new_uri(world, LV2_CORE__optionalFeature);
+	TEST_ASSERT(lilv_world_ask(world, base, opt, feature));
+	TEST_ASSERT(lilv_plugin_has_feature(plug, feature));
+	lilv_node_free(opt);
+	lilv_node_free(feature);
+	lilv_node_free(base);
+
+	// Everything is loaded, so there is nothing left to do
+	TEST_ASSERT(lilv_world_preload_plugins(world, plugins, 4) == 0);
+
+	lilv_node_free(lv2_port);
+	unlink(base_path);
+	unlink(prototype_path);
+	cleanup_uris();
+	return 1;
+}
+
+/*****************************************************************************/
+
 static int
 test_get_symbol(void)
 {
@@ -2252,6 +3019,710 @@ test_get_symbol(void)
 
 /*****************************************************************************/
 
+static LilvWorld*
+load_world_with_threads(const char* lv2_path, int n_threads)
+{
+	LilvWorld* w       = lilv_world_new();
+	LilvNode*  path    = lilv_new_string(w, lv2_path);
+	LilvNode*  threads = lilv_new_int(w, n_threads);
+
+	lilv_world_set_option(w, LILV_OPTION_LV2_PATH, path);
+	lilv_world_set_option(w, LILV_OPTION_DISCOVERY_THREADS, threads);
+	lilv_world_load_all(w);
+
+	lilv_node_free(threads);
+	lilv_node_free(path);
+	return w;
+}
+
+static int
+test_discovery_threads(void)
+{
+	// Load the test directory, which has two versions of the same plugin
+	char*      test_path = lilv_realpath(LILV_TEST_DIR);
+	LilvWorld* serial    = load_world_with_threads(test_path, 1);
+
+	world = load_world_with_threads(test_path, 4);
+
+	// Check that the same plugins were loaded from the same bundles
+	const LilvPlugins* serial_plugins = lilv_world_get_all_plugins(serial);
+	const LilvPlugins* plugins        = lilv_world_get_all_plugins(world);
+	TEST_ASSERT(lilv_plugins_size(plugins) > 0);
+	TEST_ASSERT(lilv_plugins_size(plugins) == lilv_plugins_size(serial_plugins));
+	LILV_FOREACH(plugins, i, serial_plugins) {
+		const LilvPlugin* s   = lilv_plugins_get(serial_plugins, i);
+		LilvNode*         uri = lilv_new_uri(
+			world, lilv_node_as_uri(lilv_plugin_get_uri(s)));
+		const LilvPlugin* p = lilv_plugins_get_by_uri(plugins, uri);
+		TEST_ASSERT(p);
+		TEST_ASSERT(!strcmp(lilv_node_as_uri(lilv_plugin_get_bundle_uri(p)),
+		                    lilv_node_as_uri(lilv_plugin_get_bundle_uri(s))));
+		lilv_node_free(uri);
+	}
+
+	// Check that the newest version won regardless of parsing order
+	LilvNode*         plug_uri = lilv_new_uri(world, "http://example.org/versioned");
+	const LilvPlugin* plug     = lilv_plugins_get_by_uri(plugins, plug_uri);
+	TEST_ASSERT(plug);
+	TEST_ASSERT(strstr(lilv_node_as_uri(lilv_plugin_get_bundle_uri(plug)),
+	                   "new_version.lv2"));
+
+	// Check that specifications were loaded as usual
+	TEST_ASSERT(lilv_plugin_classes_size(lilv_world_get_plugin_classes(world)) ==
+	            lilv_plugin_classes_size(lilv_world_get_plugin_classes(serial)));
+
+	lilv_node_free(plug_uri);
+	lilv_world_free(serial);
+	free(test_path);
+	return 1;
+}
+
+static LilvWorld*
+load_world_with_index(const char* lv2_path, const char* index_path)
+{
+	LilvWorld* w     = lilv_world_new();
+	LilvNode*  path  = lilv_new_string(w, lv2_path);
+	LilvNode*  index = lilv_new_string(w, index_path);
+
+	lilv_world_set_option(w, LILV_OPTION_LV2_PATH, path);
+	lilv_world_set_option(w, LILV_OPTION_DISCOVERY_INDEX, index);
+	lilv_world_load_all(w);
+
+	lilv_node_free(index);
+	lilv_node_free(path);
+	return w;
+}
+
+static bool
+plugins_match(LilvWorld* a, LilvWorld* b)
+{
+	const LilvPlugins* a_plugins = lilv_world_get_all_plugins(a);
+	const LilvPlugins* b_plugins = lilv_world_get_all_plugins(b);
+	if (lilv_plugins_size(a_plugins) != lilv_plugins_size(b_plugins)) {
+		return false;
+	}
+
+	bool match = true;
+	LILV_FOREACH(plugins, i, a_plugins) {
+		const LilvPlugin* pa  = lilv_plugins_get(a_plugins, i);
+		LilvNode*         uri = lilv_new_uri(
+			b, lilv_node_as_uri(lilv_plugin_get_uri(pa)));
+		const LilvPlugin* pb = lilv_plugins_get_by_uri(b_plugins, uri);
+		match = match && pb &&
+			!strcmp(lilv_node_as_uri(lilv_plugin_get_bundle_uri(pa)),
+			        lilv_node_as_uri(lilv_plugin_get_bundle_uri(pb)));
+		lilv_node_free(uri);
+	}
+	return match;
+}
+
+static int
+test_discovery_index(void)
+{
+	char* test_path  = lilv_realpath(LILV_TEST_DIR);
+	char* index_path = lilv_strjoin(test_path, ".index", NULL);
+	unlink(index_path);
+
+	// Load without an index, then create one, then load from it
+	LilvWorld* plain   = load_world_with_threads(test_path, 1);
+	LilvWorld* created = load_world_with_index(test_path, index_path);
+	TEST_ASSERT(lilv_path_exists(index_path, NULL));
+	world = load_world_with_index(test_path, index_path);
+
+	const LilvPlugins* plugins = lilv_world_get_all_plugins(world);
+	TEST_ASSERT(lilv_plugins_size(plugins) > 0);
+	TEST_ASSERT(plugins_match(world, plain));
+	TEST_ASSERT(plugins_match(world, created));
+
+	// Check that replayed manifests still resolve versions correctly
+	LilvNode*         plug_uri = lilv_new_uri(world, "http://example.org/versioned");
+	const LilvPlugin* plug     = lilv_plugins_get_by_uri(plugins, plug_uri);
+	TEST_ASSERT(plug);
+	TEST_ASSERT(strstr(lilv_node_as_uri(lilv_plugin_get_bundle_uri(plug)),
+	                   "new_version.lv2"));
+	lilv_node_free(plug_uri);
+	lilv_world_free(created);
+	lilv_world_free(world);
+
+	// Check that a corrupt index is ignored and replaced
+	FILE* fd = fopen(index_path, "w");
+	fprintf(fd, "lilv-discovery-index 3\nB 1 2 3\n");
+	fclose(fd);
+	world = load_world_with_index(test_path, index_path);
+	TEST_ASSERT(plugins_match(world, plain));
+	lilv_world_free(world);
+
+	world = load_world_with_index(test_path, index_path);
+	TEST_ASSERT(plugins_match(world, plain));
+	lilv_world_free(world);
+	unlink(index_path);
+
+	// Check that a manifest rewritten with the same size is not stale
+	char* lv2_path      = lilv_path_join(test_path, "index_lv2_path");
+	char* bundle_path   = lilv_path_join(lv2_path, "rewritten.lv2");
+	char* manifest_path = lilv_path_join(bundle_path, "manifest.ttl");
+	lilv_mkdir_p(bundle_path);
+	write_file(manifest_path,
+	           MANIFEST_PREFIXES
+	           "<http://example.org/rewrittenA> a lv2:Plugin ;"
+	           " lv2:binary <foo" SHLIB_EXT "> .\n");
+
+	world = load_world_with_index(lv2_path, index_path);
+	TEST_ASSERT(lilv_plugins_size(lilv_world_get_all_plugins(world)) == 1);
+	lilv_world_free(world);
+
+	write_file(manifest_path,
+	           MANIFEST_PREFIXES
+	           "<http://example.org/rewrittenB> a lv2:Plugin ;"
+	           " lv2:binary <foo" SHLIB_EXT "> .\n");
+
+	world = load_world_with_index(lv2_path, index_path);
+	plug_uri = lilv_new_uri(world, "http://example.org/rewrittenB");
+	TEST_ASSERT(lilv_plugins_get_by_uri(lilv_world_get_all_plugins(world),
+	                                    plug_uri));
+	lilv_node_free(plug_uri);
+	lilv_world_free(world);
+
+	// Check that rescanning keeps the entries of unchanged bundles
+	char* other_path     = lilv_path_join(lv2_path, "other.lv2");
+	char* other_manifest = lilv_path_join(other_path, "manifest.ttl");
+	lilv_mkdir_p(other_path);
+	write_file(other_manifest,
+	           MANIFEST_PREFIXES
+	           "<http://example.org/other> a lv2:Plugin ;"
+	           " lv2:binary <foo" SHLIB_EXT "> .\n");
+
+	world = load_world_with_index(lv2_path, index_path);
+	write_file(manifest_path,
+	           MANIFEST_PREFIXES
+	           "<http://example.org/rewrittenC> a lv2:Plugin ;"
+	           " lv2:binary <foo" SHLIB_EXT "> .\n");
+
+	LilvNodes* added = NULL;
+	TEST_ASSERT(!lilv_world_rescan(world, &added, NULL, NULL));
+	TEST_ASSERT(lilv_nodes_size(added) == 1);
+	lilv_nodes_free(added);
+	lilv_world_free(world);
+
+	LilvIndex* index = lilv_index_read(index_path);
+	TEST_ASSERT(index);
+	TEST_ASSERT(index->n_entries == 2);
+	TEST_ASSERT(strstr(index->entries[0].uri, "other.lv2/"));
+	lilv_index_free(index);
+
+	world = load_world_with_index(lv2_path, index_path);
+	TEST_ASSERT(lilv_plugins_size(lilv_world_get_all_plugins(world)) == 2);
+	plug_uri = lilv_new_uri(world, "http://example.org/rewrittenC");
+	TEST_ASSERT(lilv_plugins_get_by_uri(lilv_world_get_all_plugins(world),
+	                                    plug_uri));
+	lilv_node_free(plug_uri);
+	lilv_world_free(world);
+	world = NULL;
+
+	unlink(other_manifest);
+	remove(other_path);
+	free(other_manifest);
+	free(other_path);
+
+	unlink(manifest_path);
+	remove(bundle_path);
+	remove(lv2_path);
+	free(manifest_path);
+	free(bundle_path);
+	free(lv2_path);
+
+	unlink(index_path);
+	lilv_world_free(plain);
+	free(index_path);
+	free(test_path);
+	return 1;
+}
+
+static int
+test_mapped_files(void)
+{
+#ifdef _WIN32
+	const size_t page_size = 4096;
+#else
+	const size_t page_size = (size_t)sysconf(_SC_PAGESIZE);
+#endif
+
+	// A manifest that exactly fills its pages, which is not null terminated
+	static const char* const manifest =
+		MANIFEST_PREFIXES
+		":plug a lv2:Plugin ; lv2:binary <foo" SHLIB_EXT "> ;"
+		" rdfs:seeAlso <plugin.ttl> .\n";
+
+	const size_t manifest_len = strlen(manifest);
+	const size_t padded_len   = (manifest_len / page_size + 1) * page_size;
+	char*        padded       = (char*)calloc(1, padded_len + 1);
+	memcpy(padded, manifest, manifest_len);
+	memset(padded + manifest_len, ' ', padded_len - manifest_len - 1);
+	padded[manifest_len]   = '#';
+	padded[padded_len - 1] = '\n';
+
+	if (!start_bundle(padded,
+	                  BUNDLE_PREFIXES
+	                  ":plug a lv2:Plugin ; "
+	                  PLUGIN_NAME("Mapped plugin") " ; "
+	                  LICENSE_GPL " .")) {
+		free(padded);
+		return 0;
+	}
+
+	struct stat st;
+	TEST_ASSERT(!stat(test_manifest_path, &st));
+	TEST_ASSERT((size_t)st.st_size == padded_len);
+	TEST_ASSERT(!stat(test_content_path, &st));
+	TEST_ASSERT((size_t)st.st_size % page_size);
+
+	init_uris();
+	const LilvPlugin* plug = lilv_plugins_get_by_uri(
+		lilv_world_get_all_plugins(world), plugin_uri_value);
+	TEST_ASSERT(plug);
+
+	LilvNode* name = lilv_plugin_get_name(plug);
+	TEST_ASSERT(!strcmp(lilv_node_as_string(name), "Mapped plugin"));
+	lilv_node_free(name);
+
+	free(padded);
+	cleanup_uris();
+	return 1;
+}
+
+static int
+test_lazy_specs(void)
+{
+	create_bundle(MANIFEST_PREFIXES
+	              "<http://example.org/spec> a lv2:Specification ;"
+	              " rdfs:seeAlso <plugin.ttl> .\n"
+	              "<http://example.org/spectral> a lv2:Specification ;"
+	              " rdfs:seeAlso <spectral.ttl> .\n",
+	              BUNDLE_PREFIXES
+	              "<http://example.org/spec#Thing> rdfs:label \"Thing\" .\n");
+
+	char* const spectral_path = lilv_strjoin(
+		test_bundle_path, "/spectral.ttl", NULL);
+	write_file(spectral_path,
+	           BUNDLE_PREFIXES
+	           "<http://example.org/spectral#Thing> rdfs:label \"Other\" .\n");
+
+	if (!init_world()) {
+		return 0;
+	}
+
+	LilvNode* lazy = lilv_new_bool(world, true);
+	lilv_world_set_option(world, LILV_OPTION_LAZY_SPECS, lazy);
+	lilv_world_load_all(world);
+
+	LilvNode* thing      = lilv_new_uri(world, "http://example.org/spec#Thing");
+	LilvNode* other      = lilv_new_uri(world, "http://example.org/spectral#Thing");
+	LilvNode* rdfs_label = lilv_new_uri(world, LILV_NS_RDFS "label");
+	LilvNode* label_val  = lilv_new_string(world, "Thing");
+	LilvNode* other_val  = lilv_new_string(world, "Other");
+
+	// Specification data has not been loaded yet
+	TEST_ASSERT(!lilv_world_ask(world, NULL, rdfs_label, label_val));
+	TEST_ASSERT(!lilv_world_ask(world, NULL, rdfs_label, other_val));
+
+	// Internal queries, which may be made while iterating, never load data
+	TEST_ASSERT(!lilv_world_ask_internal(
+		world, thing->node, rdfs_label->node, NULL));
+	TEST_ASSERT(!lilv_world_ask(world, NULL, rdfs_label, label_val));
+
+	// Querying a subject in the specification namespace loads only it
+	LilvNode* label = lilv_world_get(world, thing, rdfs_label, NULL);
+	TEST_ASSERT(lilv_node_equals(label, label_val));
+	TEST_ASSERT(lilv_world_ask(world, NULL, rdfs_label, label_val));
+	TEST_ASSERT(!lilv_world_ask(world, NULL, rdfs_label, other_val));
+	lilv_node_free(label);
+
+	// A specification with the first as a string prefix is loaded separately
+	label = lilv_world_get(world, other, rdfs_label, NULL);
+	TEST_ASSERT(lilv_node_equals(label, other_val));
+	TEST_ASSERT(lilv_world_ask(world, NULL, rdfs_label, other_val));
+
+	lilv_node_free(label);
+	lilv_node_free(other_val);
+	lilv_node_free(label_val);
+	lilv_node_free(rdfs_label);
+	lilv_node_free(other);
+	lilv_node_free(thing);
+	lilv_node_free(lazy);
+	unlink(spectral_path);
+	free(spectral_path);
+	return 1;
+}
+
+static int
+test_rescan(void)
+{
+	static const char* const manifest =
+		MANIFEST_PREFIXES
+		":plug a lv2:Plugin ; lv2:binary <foo" SHLIB_EXT "> ; rdfs:seeAlso <plugin.ttl> .\n";
+	static const char* const content =
+		BUNDLE_PREFIXES
+		":plug a lv2:Plugin ; "
+		PLUGIN_NAME("Test plugin") " ; "
+		LICENSE_GPL " ; "
+		"lv2:port [ a lv2:ControlPort ; a lv2:InputPort ;"
+		" lv2:index 0 ; lv2:symbol \"foo\" ; lv2:name \"bar\" ; ] .";
+
+	if (!start_bundle(manifest, content)) {
+		return 0;
+	}
+
+	init_uris();
+
+	LilvNodes* added   = NULL;
+	LilvNodes* removed = NULL;
+	LilvNodes* changed = NULL;
+
+	// Nothing has changed since loading
+	TEST_ASSERT(!lilv_world_rescan(world, &added, &removed, &changed));
+	TEST_ASSERT(lilv_nodes_size(added) == 0);
+	TEST_ASSERT(lilv_nodes_size(removed) == 0);
+	TEST_ASSERT(lilv_nodes_size(changed) == 0);
+	lilv_nodes_free(added);
+	lilv_nodes_free(removed);
+	lilv_nodes_free(changed);
+
+	// Install a new bundle
+	char* lv2_path     = lilv_dirname(test_bundle_path);
+	char* bundle2_path = lilv_path_join(lv2_path, "lilv-rescan.lv2");
+	char* manifest2    = lilv_path_join(bundle2_path, "manifest.ttl");
+	lilv_mkdir_p(bundle2_path);
+	write_file(manifest2,
+	           MANIFEST_PREFIXES
+	           ":foobar a lv2:Plugin ; lv2:binary <foo" SHLIB_EXT "> .\n");
+
+	TEST_ASSERT(!lilv_world_rescan(world, &added, &removed, &changed));
+	TEST_ASSERT(lilv_nodes_size(added) == 1);
+	TEST_ASSERT(lilv_nodes_contains(added, plugin2_uri_value));
+	TEST_ASSERT(lilv_nodes_size(removed) == 0);
+	TEST_ASSERT(lilv_nodes_size(changed) == 0);
+	lilv_nodes_free(added);
+	lilv_nodes_free(removed);
+	lilv_nodes_free(changed);
+
+	const LilvPlugins* plugins = lilv_world_get_all_plugins(world);
+	const LilvPlugin*  plug2   = lilv_plugins_get_by_uri(plugins,
+	                                                     plugin2_uri_value);
+	TEST_ASSERT(plug2);
+
+	// Modify the original bundle
+	create_bundle(MANIFEST_PREFIXES
+	              ":plug a lv2:Plugin ; lv2:binary <foo" SHLIB_EXT "> ;"
+	              " rdfs:seeAlso <plugin.ttl> ; rdfs:comment \"Modified\" .\n",
+	              BUNDLE_PREFIXES
+	              ":plug a lv2:Plugin ; "
+	              PLUGIN_NAME("Modified plugin") " ; "
+	              LICENSE_GPL " .");
+
+	TEST_ASSERT(!lilv_world_rescan(world, &added, &removed, &changed));
+	TEST_ASSERT(lilv_nodes_size(added) == 0);
+	TEST_ASSERT(lilv_nodes_size(removed) == 0);
+	TEST_ASSERT(lilv_nodes_size(changed) == 1);
+	TEST_ASSERT(lilv_nodes_contains(changed, plugin_uri_value));
+	lilv_nodes_free(added);
+	lilv_nodes_free(removed);
+	lilv_nodes_free(changed);
+
+	const LilvPlugin* plug = lilv_plugins_get_by_uri(plugins, plugin_uri_value);
+	LilvNode*         name = lilv_plugin_get_name(plug);
+	TEST_ASSERT(!strcmp(lilv_node_as_string(name), "Modified plugin"));
+	TEST_ASSERT(lilv_plugin_get_num_ports(plug) == 0);
+	lilv_node_free(name);
+
+	// Modify only the data file of the original bundle in place
+	write_file(test_content_path,
+	           BUNDLE_PREFIXES
+	           ":plug a lv2:Plugin ; "
+	           PLUGIN_NAME("Edited plugin") " ; "
+	           LICENSE_GPL " .");
+
+	TEST_ASSERT(!lilv_world_rescan(world, &added, &removed, &changed));
+	TEST_ASSERT(lilv_nodes_size(added) == 0);
+	TEST_ASSERT(lilv_nodes_size(removed) == 0);
+	TEST_ASSERT(lilv_nodes_size(changed) == 1);
+	TEST_ASSERT(lilv_nodes_contains(changed, plugin_uri_value));
+	lilv_nodes_free(added);
+	lilv_nodes_free(removed);
+	lilv_nodes_free(changed);
+
+	plug = lilv_plugins_get_by_uri(plugins, plugin_uri_value);
+	name = lilv_plugin_get_name(plug);
+	TEST_ASSERT(!strcmp(lilv_node_as_string(name), "Edited plugin"));
+	lilv_node_free(name);
+
+	// Remove the new bundle, the plugin must still be usable
+	unlink(manifest2);
+	remove(bundle2_path);
+
+	TEST_ASSERT(!lilv_world_rescan(world, NULL, &removed, NULL));
+	TEST_ASSERT(lilv_nodes_size(removed) == 1);
+	TEST_ASSERT(lilv_nodes_contains(removed, plugin2_uri_value));
+	TEST_ASSERT(!lilv_plugins_get_by_uri(plugins, plugin2_uri_value));
+	TEST_ASSERT(lilv_node_equals(lilv_plugin_get_uri(plug2),
+	                             plugin2_uri_value));
+	lilv_nodes_free(removed);
+
+	// Data files changed after loading are detected by the first rescan
+	cleanup_uris();
+	unload_bundle();
+	load_all_bundles();
+	init_uris();
+	write_file(test_content_path,
+	           BUNDLE_PREFIXES
+	           ":plug a lv2:Plugin ; "
+	           PLUGIN_NAME("Rewritten plugin") " ; "
+	           LICENSE_GPL " .");
+
+	TEST_ASSERT(!lilv_world_rescan(world, NULL, NULL, &changed));
+	TEST_ASSERT(lilv_nodes_size(changed) == 1);
+	lilv_nodes_free(changed);
+
+	plugins = lilv_world_get_all_plugins(world);
+	plug    = lilv_plugins_get_by_uri(plugins, plugin_uri_value);
+	name    = lilv_plugin_get_name(plug);
+	TEST_ASSERT(!strcmp(lilv_node_as_string(name), "Rewritten plugin"));
+	lilv_node_free(name);
+
+	// Nothing has changed since the last rescan
+	TEST_ASSERT(!lilv_world_rescan(world, NULL, NULL, &changed));
+	TEST_ASSERT(lilv_nodes_size(changed) == 0);
+	lilv_nodes_free(changed);
+
+	free(manifest2);
+	free(bundle2_path);
+	free(lv2_path);
+	cleanup_uris();
+	return 1;
+}
+
+/** Wait up to 10 seconds for the watcher to notice changes. */
+static bool
+wait_for_pending_changes(void)
+{
+	for (unsigned i = 0; i < 200; ++i) {
+		if (lilv_world_has_pending_changes(world)) {
+			return true;
+		}
+#ifdef _WIN32
+		Sleep(50);
+#else
+		const struct timespec delay = { 0, 50000000 };
+		nanosleep(&delay, NULL);
+#endif
+	}
+	return false;
+}
+
+static int
+test_watch(void)
+{
+	if (!start_bundle(MANIFEST_PREFIXES
+	                  ":plug a lv2:Plugin ; lv2:binary <foo" SHLIB_EXT "> ;"
+	                  " rdfs:seeAlso <plugin.ttl> .\n",
+	                  BUNDLE_PREFIXES
+	                  ":plug a lv2:Plugin ; "
+	                  PLUGIN_NAME("Test plugin") " ; "
+	                  LICENSE_GPL " .")) {
+		return 0;
+	}
+
+	if (lilv_world_watch(world)) {
+		return TEST_SKIPPED;  // Not supported on this system
+	}
+
+	init_uris();
+
+	LilvNodes* added   = NULL;
+	LilvNodes* removed = NULL;
+	TEST_ASSERT(!lilv_world_has_pending_changes(world));
+
+	// Install a new bundle
+	char* lv2_path     = lilv_dirname(test_bundle_path);
+	char* bundle2_path = lilv_path_join(lv2_path, "lilv-watch.lv2");
+	char* manifest2    = lilv_path_join(bundle2_path, "manifest.ttl");
+	lilv_mkdir_p(bundle2_path);
+	write_file(manifest2,
+	           MANIFEST_PREFIXES
+	           ":foobar a lv2:Plugin ; lv2:binary <foo" SHLIB_EXT "> .\n");
+
+	TEST_ASSERT(wait_for_pending_changes());
+	TEST_ASSERT(!lilv_world_apply_pending_changes(world, &added, &removed,
+	                                              NULL));
+	TEST_ASSERT(!lilv_world_has_pending_changes(world));
+	TEST_ASSERT(lilv_nodes_size(added) == 1);
+	TEST_ASSERT(lilv_nodes_contains(added, plugin2_uri_value));
+	TEST_ASSERT(lilv_nodes_size(removed) == 0);
+	TEST_ASSERT(lilv_plugins_get_by_uri(lilv_world_get_all_plugins(world),
+	                                    plugin2_uri_value));
+	lilv_nodes_free(added);
+	lilv_nodes_free(removed);
+
+	// Remove it again
+	unlink(manifest2);
+	remove(bundle2_path);
+
+	TEST_ASSERT(wait_for_pending_changes());
+	TEST_ASSERT(!lilv_world_apply_pending_changes(world, &added, &removed,
+	                                              NULL));
+	TEST_ASSERT(lilv_nodes_size(added) == 0);
+	TEST_ASSERT(lilv_nodes_size(removed) == 1);
+	TEST_ASSERT(lilv_nodes_contains(removed, plugin2_uri_value));
+	TEST_ASSERT(!lilv_plugins_get_by_uri(lilv_world_get_all_plugins(world),
+	                                     plugin2_uri_value));
+	lilv_nodes_free(added);
+	lilv_nodes_free(removed);
+
+	// Edit the data file of the original bundle in place
+	LilvNodes* changed = NULL;
+	write_file(test_content_path,
+	           BUNDLE_PREFIXES
+	           ":plug a lv2:Plugin ; "
+	           PLUGIN_NAME("Edited plugin") " ; "
+	           LICENSE_GPL " .");
+
+	TEST_ASSERT(wait_for_pending_changes());
+	TEST_ASSERT(!lilv_world_apply_pending_changes(world, &added, &removed,
+	                                              &changed));
+	TEST_ASSERT(lilv_nodes_size(added) == 0);
+	TEST_ASSERT(lilv_nodes_size(removed) == 0);
+	TEST_ASSERT(lilv_nodes_size(changed) == 1);
+	TEST_ASSERT(lilv_nodes_contains(changed, plugin_uri_value));
+	lilv_nodes_free(added);
+	lilv_nodes_free(removed);
+	lilv_nodes_free(changed);
+
+	const LilvPlugin* plug = lilv_plugins_get_by_uri(
+		lilv_world_get_all_plugins(world), plugin_uri_value);
+	LilvNode* name = lilv_plugin_get_name(plug);
+	TEST_ASSERT(!strcmp(lilv_node_as_string(name), "Edited plugin"));
+	lilv_node_free(name);
+
+	// Move in a bundle with its data in a subdirectory
+	char* test_path = lilv_dirname(lv2_path);
+	char* tmp_path  = lilv_path_join(test_path, "lilv-watch.lv2");
+	char* data_path = lilv_path_join(bundle2_path, "data");
+	char* data_ttl  = lilv_path_join(data_path, "plugin.ttl");
+	char* tmp_data  = lilv_path_join(tmp_path, "data");
+	char* tmp_ttl   = lilv_path_join(tmp_data, "plugin.ttl");
+	char* tmp_man   = lilv_path_join(tmp_path, "manifest.ttl");
+	lilv_mkdir_p(tmp_data);
+	write_file(tmp_man,
+	           MANIFEST_PREFIXES
+	           ":foobar a lv2:Plugin ; lv2:binary <foo" SHLIB_EXT "> ;"
+	           " rdfs:seeAlso <data/plugin.ttl> .\n");
+	write_file(tmp_ttl,
+	           BUNDLE_PREFIXES
+	           ":foobar a lv2:Plugin ; "
+	           PLUGIN_NAME("Nested plugin") " ; "
+	           LICENSE_GPL " .");
+	TEST_ASSERT(!rename(tmp_path, bundle2_path));
+
+	TEST_ASSERT(wait_for_pending_changes());
+	TEST_ASSERT(!lilv_world_apply_pending_changes(world, &added, &removed,
+	                                              NULL));
+	TEST_ASSERT(lilv_nodes_size(added) == 1);
+	TEST_ASSERT(lilv_nodes_contains(added, plugin2_uri_value));
+	lilv_nodes_free(added);
+	lilv_nodes_free(removed);
+
+	// Edit the data file in the subdirectory in place
+	write_file(data_ttl,
+	           BUNDLE_PREFIXES
+	           ":foobar a lv2:Plugin ; "
+	           PLUGIN_NAME("Edited nested plugin") " ; "
+	           LICENSE_GPL " .");
+
+	TEST_ASSERT(wait_for_pending_changes());
+	TEST_ASSERT(!lilv_world_apply_pending_changes(world, &added, &removed,
+	                                              &changed));
+	TEST_ASSERT(lilv_nodes_size(added) == 0);
+	TEST_ASSERT(lilv_nodes_size(removed) == 0);
+	TEST_ASSERT(lilv_nodes_size(changed) == 1);
+	TEST_ASSERT(lilv_nodes_contains(changed, plugin2_uri_value));
+	lilv_nodes_free(added);
+	lilv_nodes_free(removed);
+	lilv_nodes_free(changed);
+
+	plug = lilv_plugins_get_by_uri(lilv_world_get_all_plugins(world),
+	                               plugin2_uri_value);
+	name = lilv_plugin_get_name(plug);
+	TEST_ASSERT(!strcmp(lilv_node_as_string(name), "Edited nested plugin"));
+	lilv_node_free(name);
+
+	unlink(data_ttl);
+	remove(data_path);
+	unlink(manifest2);
+	remove(bundle2_path);
+
+	free(tmp_man);
+	free(tmp_ttl);
+	free(tmp_data);
+	free(data_ttl);
+	free(data_path);
+	free(tmp_path);
+	free(test_path);
+	free(manifest2);
+	free(bundle2_path);
+	free(lv2_path);
+	cleanup_uris();
+	return 1;
+}
+
+static int
+test_manifest_version(void)
+{
+	// Two bundles with versions of the same plugin only given in manifests
+	char* test_path = lilv_realpath(LILV_TEST_DIR);
+	char* lv2_path  = lilv_path_join(test_path, "version_lv2_path");
+	char* old_path  = lilv_path_join(lv2_path, "old.lv2");
+	char* new_path  = lilv_path_join(lv2_path, "new.lv2");
+	char* old_ttl   = lilv_path_join(old_path, "manifest.ttl");
+	char* new_ttl   = lilv_path_join(new_path, "manifest.ttl");
+	lilv_mkdir_p(old_path);
+	lilv_mkdir_p(new_path);
+	write_file(old_ttl,
+	           MANIFEST_PREFIXES
+	           ":plug a lv2:Plugin ; lv2:binary <foo" SHLIB_EXT "> ;"
+	           " lv2:minorVersion 1 ; lv2:microVersion 2 ;"
+	           " rdfs:seeAlso <missing.ttl> .\n");
+	write_file(new_ttl,
+	           MANIFEST_PREFIXES
+	           ":plug a lv2:Plugin ; lv2:binary <foo" SHLIB_EXT "> ;"
+	           " lv2:minorVersion 1 ; lv2:microVersion 4 ;"
+	           " rdfs:seeAlso <missing.ttl> .\n");
+
+	world = load_world_with_threads(lv2_path, 1);
+	init_uris();
+
+	// Check that the newest version won, without needing any data files
+	const LilvPlugin* plug = lilv_plugins_get_by_uri(
+		lilv_world_get_all_plugins(world), plugin_uri_value);
+	TEST_ASSERT(plug);
+	TEST_ASSERT(strstr(lilv_node_as_uri(lilv_plugin_get_bundle_uri(plug)),
+	                   "new.lv2"));
+
+	cleanup_uris();
+	unlink(old_ttl);
+	unlink(new_ttl);
+	remove(old_path);
+	remove(new_path);
+	remove(lv2_path);
+	free(new_ttl);
+	free(old_ttl);
+	free(new_path);
+	free(old_path);
+	free(lv2_path);
+	free(test_path);
+	return 1;
+}
+
+/*****************************************************************************/
+
 /* add tests here */
 static struct TestCase tests[] = {
 	TEST_CASE(util),
@@ -2267,6 +3738,7 @@ static struct TestCase tests[] = {
 	TEST_CASE(preset),
 	TEST_CASE(prototype),
 	TEST_CASE(port),
+	TEST_CASE(port_table),
 	TEST_CASE(ui),
 	TEST_CASE(bad_port_symbol),
 	TEST_CASE(bad_port_index),
@@ -2278,8 +3750,20 @@ static struct TestCase tests[] = {
 	TEST_CASE(state),
 #endif
 	TEST_CASE(reload_bundle),
+	TEST_CASE(unload_bundle_files),
 	TEST_CASE(replace_version),
+	TEST_CASE(replaced_by),
+	TEST_CASE(hostable),
+	TEST_CASE(summary),
+	TEST_CASE(preload),
+	TEST_CASE(manifest_version),
 	TEST_CASE(get_symbol),
+	TEST_CASE(discovery_threads),
+	TEST_CASE(discovery_index),
+	TEST_CASE(lazy_specs),
+	TEST_CASE(rescan),
+	TEST_CASE(watch),
+	TEST_CASE(mapped_files),
 	{ NULL, NULL }
 };
 
@@ -2289,7 +3773,11 @@ run_tests(void)
 	int i;
 	for (i = 0; tests[i].title; i++) {
 		printf("*** Test %s\n", tests[i].title);
-		if (!tests[i].func()) {
+		const int result = tests[i].func();
+		if (result == TEST_SKIPPED) {
+			printf("Test skipped\n");
+			++skip_count;
+		} else if (!result) {
 			printf("\nTest failed\n");
 			/* test case that wasn't able to be executed at all counts as 1 test + 1 error */
 			error_count++;
@@ -2311,6 +3799,7 @@ main(int argc, char* argv[])
 	init_tests();
 	run_tests();
 	cleanup();
-	printf("\n*** Test Results: %d tests, %d errors\n\n", test_count, error_count);
+	printf("\n*** Test Results: %d tests, %d errors, %d skipped\n\n",
+	       test_count, error_count, skip_count);
 	return error_count ? 1 : 0;
 }